@@ -18,7 +18,10 @@ void main()
         color = vec4(color_mask.r * f_color, color_mask.a);
     } else {
         color = texture(texture0, vec3(f_uv, f_textures.x));
+        // far away alpha tested blocks are a few pixels wide, without any discard the far program keeps early depth testing
+#ifndef FAR
         if (color.a < 0.1) discard; // discard (almost) transparent fragment
+#endif
     }
 
     color = vec4(f_light.r * color.r, f_light.g * color.g, f_light.b * color.b, color.a);
@@ -11,12 +11,24 @@ out vec3 f_color;
 out vec3 f_light;
 flat out uvec2 f_textures;
 
-uniform mat4 projection;
-uniform mat4 view;
+// engine::rendering::opengl::FrameBlock
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 projection;
+    vec3 camera_position;
+    float time;
+};
+
+// engine::rendering::opengl::DrawBlock
+layout(std140) uniform Draw {
+    vec3 chunk_origin;
+    float lod;
+    float fade;
+};
 
 void main()
 {
-    gl_Position = projection * view * vec4(v_position, 1);
+    gl_Position = projection * view * vec4(chunk_origin + v_position, 1);
     f_uv = v_uv;
     f_color = v_color;
     f_light = v_light;
@@ -1,13 +1,19 @@
 #ifndef ENGINE_BLOCK_HPP
 #define ENGINE_BLOCK_HPP
 
+#include <engine/serializable_component.hpp>
+
 #include <entt/entity/entity.hpp>
 
 namespace engine {
+    // per block data lives in the chunk's engine::BlockPayloads, most blocks don't have any
     struct Block {
         entt::id_type type_id = entt::null;
-        entt::id_type data_id = entt::null;
+
+        friend constexpr bool operator==(Block const &, Block const &) noexcept = default;
     };
 } // namespace engine
 
+SERIALIZABLE_COMPONENT(engine::Block, type_id)
+
 #endif
\ No newline at end of file
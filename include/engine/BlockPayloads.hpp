@@ -0,0 +1,104 @@
+#ifndef ENGINE_BLOCKPAYLOADS_HPP
+#define ENGINE_BLOCKPAYLOADS_HPP
+
+#include <engine/serializable_component.hpp>
+
+#include <boost/serialization/vector.hpp>
+#include <entt/entity/entity.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+    /**
+     * extra data of the few blocks of a chunk that have some, like the color of a colorful_block
+     * keyed by index in the chunk's blocks, most chunks have none so it's a sorted vector
+     */
+    struct BlockPayloads {
+        struct Entry {
+            std::uint16_t index;
+            entt::id_type payload;
+
+            friend constexpr bool operator==(Entry const &, Entry const &) noexcept = default;
+        };
+
+        // sorted by index, without duplicates
+        std::vector<Entry> entries;
+
+        // entt::null if the block has none
+        [[nodiscard]]
+        entt::id_type get(std::size_t index) const noexcept
+        {
+            auto const it = find(index);
+            return it != entries.end() && it->index == index ? it->payload : static_cast<entt::id_type>(entt::null);
+        }
+
+        // entt::null removes it
+        void set(std::size_t index, entt::id_type payload)
+        {
+            auto const it = find(index);
+            bool const exists = it != entries.end() && it->index == index;
+            if (payload == entt::null) {
+                if (exists) entries.erase(it);
+            } else if (exists) {
+                it->payload = payload;
+            } else {
+                entries.insert(it, Entry { static_cast<std::uint16_t>(index), payload });
+            }
+        }
+
+        void erase(std::size_t index)
+        {
+            set(index, entt::null);
+        }
+
+        // only the blocks that have a payload, by increasing index
+        [[nodiscard]]
+        auto begin() const noexcept
+        {
+            return entries.begin();
+        }
+
+        [[nodiscard]]
+        auto end() const noexcept
+        {
+            return entries.end();
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return entries.size();
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return entries.empty();
+        }
+
+        friend bool operator==(BlockPayloads const &, BlockPayloads const &) noexcept = default;
+
+    private:
+        [[nodiscard]]
+        std::vector<Entry>::const_iterator find(std::size_t index) const noexcept
+        {
+            return std::ranges::lower_bound(entries, index, {}, &Entry::index);
+        }
+
+        [[nodiscard]]
+        std::vector<Entry>::iterator find(std::size_t index) noexcept
+        {
+            return std::ranges::lower_bound(entries, index, {}, &Entry::index);
+        }
+    };
+
+} // namespace engine
+
+SERIALIZABLE_COMPONENT(engine::BlockPayloads::Entry, index, payload)
+SERIALIZABLE_COMPONENT(engine::BlockPayloads, entries)
+
+#endif
\ No newline at end of file
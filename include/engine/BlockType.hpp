@@ -5,12 +5,25 @@
 
 #include <vector>
 
+namespace engine::assets {
+    class BlockMesh;
+}
+
 namespace engine {
 
     struct BlockType {
         entt::id_type mesh_id = entt::null;
         std::vector<entt::id_type> texture_ids;
         std::vector<entt::id_type> masks_ids;
+
+        // what the block counts as for the heightmaps, see engine::components::Heightmap
+        // opaque blocks also close chunks for culling and motion blocking ones are collided with
+        bool opaque = false;
+        bool motion_blocking = false;
+
+        // a block drawn with the mesh, classified by the mesh's faces
+        [[nodiscard]]
+        static BlockType from_mesh(entt::id_type mesh_id, engine::assets::BlockMesh const &);
     };
 
 } // namespace engine
@@ -31,9 +31,37 @@ namespace engine {
             std::optional<std::string> font_path;
         } imgui;
 
+        struct {
+            // store chunks uncompressed so they can be used straight from the memory mapped region files
+            bool uncompressed = false;
+            // seconds between saves of the modified chunks
+            unsigned autosave_interval = 30;
+        } world;
+
+        struct {
+            // chunk mesh bytes uploaded per frame, the nearest chunk is always uploaded even if it's bigger
+            unsigned upload_budget = 4u << 20;
+            // milliseconds spent meshing and uploading chunks per frame
+            unsigned upload_time_budget = 4;
+            // chunks further than this from the camera are drawn with the far permutation of their material, 0 never
+            unsigned far_distance = 8;
+
+            // renders into a framebuffer of a hidden window, to measure rendering on machines without a display
+            struct {
+                bool enabled = false;
+                unsigned width = 1280;
+                unsigned height = 720;
+                // every how many frames the framebuffer is saved to the cache folder, 0 never
+                unsigned dump_interval = 0;
+                // frames rendered before quitting, 0 runs until closed
+                unsigned frames = 0;
+            } headless;
+        } rendering;
+
         struct {
             std::filesystem::path root = ".";
             std::filesystem::path cache = root / "cache";
+            std::filesystem::path saves = root / "saves";
         } folders;
 
         static Config const &load(std::filesystem::path const &);
@@ -23,6 +23,13 @@ namespace engine {
         }
     };
 
+    /**
+     * maps the whole file as read only
+     * @throws std::system_error or boost::interprocess::interprocess_exception if it can't be mapped
+     */
+    [[nodiscard]]
+    boost::interprocess::mapped_region map_to_memory(std::FILE *fp);
+
     template <typename Ptr>
     struct FileBytes;
 
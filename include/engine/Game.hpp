@@ -9,11 +9,21 @@
 #include <engine/rendering/IRenderer.hpp>
 #include <engine/rendering/Mesh.hpp>
 #include <engine/sdl/Window.hpp>
+#include <engine/system/async_io.hpp>
+#include <engine/world/ChunkStreamer.hpp>
+#include <engine/world/Dimension.hpp>
+#include <engine/world/RegionStorage.hpp>
+#include <engine/world/WorldSaver.hpp>
+#include <engine/world/chunk_blocks.hpp>
+#include <engine/world/collision.hpp>
 
 #include <boost/circular_buffer.hpp>
 #include <entt/entt.hpp>
+#include <utils/thread_pool.hpp>
 
 #include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -34,13 +44,31 @@ namespace engine {
         void input(SDL_Event const &);
         void cleanup();
 
-        int get_texture_index(std::string_view) const noexcept;
+        // registry of the dimension the player is in
+        entt::registry &registry()
+        {
+            return current_dimension().registry();
+        }
+
+        // created the first time it's used
+        engine::world::Dimension &dimension(std::int32_t id);
 
-        entt::registry &registry() noexcept
+        // nullptr if nothing was ever loaded in it
+        [[nodiscard]]
+        engine::world::Dimension const *find_dimension(std::int32_t id) const noexcept;
+
+        engine::world::Dimension &current_dimension()
         {
-            return m_entity_registry;
+            return dimension(m_current_dimension);
         }
 
+        /**
+         * first block along a ray, for picking and line of sight checks
+         * safe to call from many threads at once outside of update()
+         */
+        [[nodiscard]]
+        std::optional<engine::world::RaycastHit> raycast(std::int32_t dimension, glm::vec3 origin, glm::vec3 direction, float max_distance) const noexcept;
+
         engine::sdl::Window &window() noexcept
         {
             return m_window.value();
@@ -51,13 +79,31 @@ namespace engine {
     private:
         void setup_renderer();
 
-        void on_chunk_construct(entt::registry &, entt::entity chunk);
-        void on_chunk_destroy(entt::registry &, entt::entity chunk);
+        void stream_chunks();
+
+        // the local player is created the first time, its camera ends up at the given position
+        void place_local_player(glm::vec3 camera_position);
+
+        /**
+         * updates the dimensions that have something to do, in parallel when there's more than one
+         * dimensions don't share state, the only shared things are read only or synchronized
+         */
+        void tick_dimensions(float delta, bool autosave);
+        static void tick_dimension(Game *, engine::world::Dimension *, float delta, bool autosave);
+
+        entt::entity generate_chunk(engine::world::Dimension &, engine::components::ChunkPosition const &);
 
     public:
-        rendering::Mesh generate_solid_mesh(engine::components::ChunkPosition const &, engine::components::ChunkData const &);
+        // both in chunk coordinates, the renderer moves them where the chunk is
+        rendering::Mesh generate_solid_mesh(engine::world::ChunkBlocks blocks, engine::BlockPayloads const &payloads);
         rendering::Mesh generate_translucent_mesh(engine::components::ChunkPosition const &coord);
 
+        /**
+         * loads the chunk from the world save in the background, it is generated if it was never saved
+         * the entity shows up in a later update
+         */
+        void request_chunk(engine::components::ChunkPosition const &);
+
         bool running;
 
         auto &block_registry() noexcept
@@ -79,12 +125,19 @@ namespace engine {
         std::unique_ptr<rendering::IRenderer> m_renderer = nullptr;
         std::optional<engine::sdl::Window> m_window;
 
-        entt::registry m_entity_registry;
-        std::unordered_map<engine::components::ChunkPosition, entt::entity> m_chunks;
-        // utils::octtree<std::int32_t, entt::entity> m_chunks;
+        std::map<std::int32_t, std::unique_ptr<engine::world::Dimension>> m_dimensions;
+        std::int32_t m_current_dimension = 0;
+        std::optional<utils::thread_pool<void, Game *, engine::world::Dimension *, float, bool>> m_dimension_pool;
+        std::optional<engine::world::RegionStorage> m_world_storage;
+        std::unique_ptr<engine::system::IAsyncIO> m_async_io;
+        std::optional<engine::world::ChunkStreamer> m_chunk_streamer;
+        std::optional<engine::world::WorldSaver> m_world_saver;
+        std::chrono::duration<double> m_since_autosave {};
+        entt::entity m_local_player = entt::null;
 
         engine::named_storage<engine::BlockType> m_block_registry;
         entt::storage<engine::assets::BlockMesh> m_block_meshes;
+        engine::world::CollisionShapes m_collision_shapes;
     };
 
 } // namespace engine
@@ -32,6 +32,18 @@ namespace engine::assets {
             return get_mesh(i);
         }
 
+        // every side is closed by solid faces and none of them is translucent
+        bool opaque() const noexcept
+        {
+            return m_opaque;
+        }
+
+        // has any solid face
+        bool solid() const noexcept
+        {
+            return m_solid;
+        }
+
     private:
         bool has_mesh(std::size_t i) const noexcept
         {
@@ -56,6 +68,8 @@ namespace engine::assets {
     private:
         engine::OptionalArray<engine::rendering::Mesh, 128> m_meshes;
         boost::container::small_vector<std::uint32_t, 4> m_textures;
+        bool m_opaque = false;
+        bool m_solid = false;
     };
 
 }
@@ -18,6 +18,11 @@ namespace engine::assets {
     public:
         explicit Image(std::string_view);
 
+        // an uninitialized image with 4 bytes per pixel, red first
+        void create(std::uint32_t width, std::uint32_t height);
+        // to one of SDL_PixelFormatEnum
+        void convert(std::uint32_t pixel_format);
+
         void load(std::filesystem::path const &path) override;
         void load(std::span<std::byte const> bytes, std::optional<std::string_view> format = std::nullopt);
 
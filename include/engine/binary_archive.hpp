@@ -0,0 +1,201 @@
+#ifndef ENGINE_BINARY_ARCHIVE_HPP
+#define ENGINE_BINARY_ARCHIVE_HPP
+
+#include <engine/serializable_component.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+    namespace serialization {
+        // types that can be put in the other byte order member by member
+        template <typename T>
+        constexpr bool is_byte_swappable_v = std::is_arithmetic_v<T> || std::is_enum_v<T> || members<std::remove_cv_t<T>>::declared;
+
+        template <typename T, std::size_t N>
+        constexpr bool is_byte_swappable_v<T[N]> = is_byte_swappable_v<T>;
+
+        template <typename T>
+        constexpr bool is_vector_v = false;
+
+        template <typename T, typename Allocator>
+        constexpr bool is_vector_v<std::vector<T, Allocator>> = true;
+
+        template <typename T>
+        void swap_bytes(T &value) noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>) {
+                // single byte
+            } else if constexpr (std::is_integral_v<T>) {
+                value = std::byteswap(value);
+            } else if constexpr (std::is_enum_v<T>) {
+                value = static_cast<T>(std::byteswap(std::to_underlying(value)));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                using bits_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                value = std::bit_cast<T>(std::byteswap(std::bit_cast<bits_type>(value)));
+            } else if constexpr (std::is_array_v<T>) {
+                for (auto &element : value)
+                    swap_bytes(element);
+            } else {
+                members<T>::visit(value, [](auto &member) { swap_bytes(member); });
+            }
+        }
+    } // namespace serialization
+
+    /**
+     * binary archive for SERIALIZABLE_COMPONENT types
+     *
+     * trivially copyable values are written with a single memcpy in the native byte order,
+     * vectors as their size followed by their elements, the rest member by member. the archive starts with a header recording the byte order
+     * so a reader on a different machine can still swap the values it reads.
+     */
+    class BinaryOutputArchive {
+    public:
+        static constexpr std::uint16_t version = 1;
+
+        // appends the archive to buffer
+        explicit BinaryOutputArchive(std::vector<std::byte> &buffer);
+
+        void write_bytes(std::span<std::byte const> bytes)
+        {
+            m_buffer->insert(m_buffer->end(), bytes.begin(), bytes.end());
+        }
+
+        template <typename T>
+        void write(T const &value)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                write_bytes(std::as_bytes(std::span(&value, 1)));
+            } else if constexpr (serialization::is_vector_v<T>) {
+                write(static_cast<std::uint64_t>(value.size()));
+                write_span(std::span<typename T::value_type const>(value));
+            } else {
+                static_assert(serialization::members<T>::declared, "T must be trivially copyable or declared with SERIALIZABLE_COMPONENT");
+                serialization::members<T>::visit(value, [this](auto const &member) { write(member); });
+            }
+        }
+
+        template <typename T>
+        void write_span(std::span<T const> values)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                write_bytes(std::as_bytes(values));
+            } else {
+                for (auto const &value : values)
+                    write(value);
+            }
+        }
+
+        template <typename T>
+        BinaryOutputArchive &operator<<(T const &value)
+        {
+            write(value);
+            return *this;
+        }
+
+    private:
+        std::vector<std::byte> *m_buffer;
+    };
+
+    class BinaryInputArchive {
+    public:
+        /**
+         * @throws engine::errors::CorruptedData if bytes don't start with a supported archive header
+         */
+        explicit BinaryInputArchive(std::span<std::byte const> bytes);
+
+        /**
+         * @throws engine::errors::CorruptedData if the archive is too short
+         */
+        void read_bytes(std::span<std::byte> bytes);
+
+        /**
+         * the next size bytes where they are in the archive, without copying them
+         * @throws engine::errors::CorruptedData if the archive is too short
+         */
+        [[nodiscard]]
+        std::span<std::byte const> view_bytes(std::size_t size);
+
+        template <typename T>
+        void read(T &value)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                read_bytes(std::as_writable_bytes(std::span(&value, 1)));
+                if (m_swapped) swap_value(value);
+            } else if constexpr (serialization::is_vector_v<T>) {
+                std::uint64_t size;
+                read(size);
+                // every element takes at least a byte
+                if (size > remaining()) throw_truncated();
+                value.resize(size);
+                read_span(std::span(value));
+            } else {
+                static_assert(serialization::members<T>::declared, "T must be trivially copyable or declared with SERIALIZABLE_COMPONENT");
+                serialization::members<T>::visit(value, [this](auto &member) { read(member); });
+            }
+        }
+
+        template <typename T>
+        void read_span(std::span<T> values)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                read_bytes(std::as_writable_bytes(values));
+                if (m_swapped)
+                    for (auto &value : values)
+                        swap_value(value);
+            } else {
+                for (auto &value : values)
+                    read(value);
+            }
+        }
+
+        template <typename T>
+        BinaryInputArchive &operator>>(T &value)
+        {
+            read(value);
+            return *this;
+        }
+
+        // whether the archive was written with the other byte order
+        [[nodiscard]]
+        bool swapped() const noexcept
+        {
+            return m_swapped;
+        }
+
+        [[nodiscard]]
+        std::size_t remaining() const noexcept
+        {
+            return m_bytes.size();
+        }
+
+    private:
+        template <typename T>
+        void swap_value(T &value)
+        {
+            if constexpr (serialization::is_byte_swappable_v<T>)
+                serialization::swap_bytes(value);
+            else
+                throw_not_swappable();
+        }
+
+        [[noreturn]]
+        static void throw_not_swappable();
+
+        [[noreturn]]
+        void throw_truncated() const;
+
+        std::span<std::byte const> m_bytes;
+        bool m_swapped = false;
+    };
+
+} // namespace engine
+
+#endif
\ No newline at end of file
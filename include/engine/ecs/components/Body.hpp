@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+namespace engine::components {
+
+    /**
+     * an axis aligned box that moves through the world and collides with its blocks
+     * moved by engine::world::move_bodies every time its dimension is ticked
+     */
+    struct Body {
+        // centre of the box
+        glm::vec3 position {};
+        glm::vec3 half_extents { 0.3f, 0.9f, 0.3f };
+        // blocks per second
+        glm::vec3 velocity {};
+        // ledges up to this high are climbed instead of stopping against them
+        float step_height = 0.5f;
+        bool on_ground = false;
+    };
+
+} // namespace engine::components
\ No newline at end of file
@@ -1,16 +1,19 @@
 #pragma once
 
 #include <engine/Block.hpp>
+#include <engine/BlockPayloads.hpp>
 #include <engine/serializable_component.hpp>
 
 namespace engine::components {
 
     struct ChunkData {
         constexpr static std::size_t chunk_size = 16u;
+        constexpr static std::size_t block_count = chunk_size * chunk_size * chunk_size;
 
-        engine::Block blocks[chunk_size * chunk_size * chunk_size];
+        engine::Block blocks[block_count];
+        engine::BlockPayloads payloads;
     };
 
 } // namespace engine::components
 
-SERIALIZABLE_COMPONENT(engine::components::ChunkData, blocks)
+SERIALIZABLE_COMPONENT(engine::components::ChunkData, blocks, payloads)
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <engine/ecs/components/ChunkData.hpp>
+
+#include <boost/container_hash/hash.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace engine::components {
+
+    // a vertical stack of chunks, what heightmaps are attached to
+    struct ColumnPosition {
+        std::int32_t x {};
+        std::int32_t z {};
+
+        friend constexpr bool operator==(ColumnPosition const &, ColumnPosition const &) noexcept = default;
+    };
+
+    /**
+     * topmost block of every (x, z) of a chunk column, lives on its own entity next to the chunks
+     * only the loaded chunks of the column are taken into account
+     * kept up to date by engine::world::Dimension as chunks come and go and blocks change
+     */
+    struct Heightmap {
+        enum class Kind : std::uint8_t {
+            // anything that isn't air
+            any,
+            // blocks skylight can't go through, it starts right above these
+            opaque,
+            // blocks entities collide with
+            motion_blocking,
+        };
+        static constexpr std::size_t kind_count = 3;
+
+        // a bit for every kind a block counts as
+        using Mask = std::uint8_t;
+
+        [[nodiscard]]
+        static constexpr Mask mask_of(Kind kind) noexcept
+        {
+            return static_cast<Mask>(1u << static_cast<unsigned>(kind));
+        }
+
+        // height of a (x, z) without a block of that kind
+        static constexpr std::int32_t none = std::numeric_limits<std::int32_t>::min();
+
+        static constexpr std::size_t chunk_size = ChunkData::chunk_size;
+
+        // world y of the topmost block, indexed by kind and then local x * chunk_size + z
+        std::int32_t heights[kind_count][chunk_size * chunk_size];
+        // y of the loaded chunks of the column, sorted
+        std::vector<std::int32_t> chunks;
+
+        [[nodiscard]]
+        std::int32_t height(Kind kind, std::uint32_t x, std::uint32_t z) const noexcept
+        {
+            return heights[static_cast<std::size_t>(kind)][x * chunk_size + z];
+        }
+
+        [[nodiscard]]
+        std::int32_t &height(Kind kind, std::uint32_t x, std::uint32_t z) noexcept
+        {
+            return heights[static_cast<std::size_t>(kind)][x * chunk_size + z];
+        }
+    };
+
+} // namespace engine::components
+
+namespace std {
+
+    template <>
+    struct hash<engine::components::ColumnPosition> {
+        std::size_t operator()(engine::components::ColumnPosition const &position) const noexcept
+        {
+            std::int32_t const arr[] = { position.x, position.z };
+            return boost::hash_value(arr);
+        }
+    };
+
+}
\ No newline at end of file
@@ -2,5 +2,7 @@
 
 namespace engine::components {
     struct LocalPlayer {
+        // the camera is this far above the centre of the player's body
+        static constexpr float eye_height = 0.7f;
     };
 } // namespace engine::components
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <engine/Block.hpp>
+#include <engine/BlockPayloads.hpp>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <memory>
+
+namespace engine::components {
+
+    /**
+     * blocks of a chunk used in place from a memory mapped region file
+     * read only, replaced by ChunkData on the first write (see engine::world::writable_chunk)
+     */
+    struct MappedChunkData {
+        std::shared_ptr<boost::interprocess::mapped_region const> mapping;
+        engine::Block const *blocks;
+        // decoded, they're small
+        engine::BlockPayloads payloads;
+    };
+
+} // namespace engine::components
\ No newline at end of file
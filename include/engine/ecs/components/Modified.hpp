@@ -0,0 +1,11 @@
+#pragma once
+
+#include <engine/serializable_component.hpp>
+
+namespace engine::components {
+    // the chunk changed since it was last saved, unlike Dirty which is about its mesh
+    struct Modified {
+    };
+} // namespace engine::components
+
+SERIALIZABLE_COMPONENT(engine::components::Modified)
\ No newline at end of file
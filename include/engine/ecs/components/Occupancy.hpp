@@ -0,0 +1,52 @@
+#pragma once
+
+#include <engine/ecs/components/ChunkData.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine::components {
+
+    /**
+     * which blocks of a chunk aren't air, split in 4x4x4 bricks so rays can skip empty space
+     * lives next to the chunk's blocks, kept up to date by engine::world::Dimension
+     */
+    struct Occupancy {
+        static constexpr std::size_t brick_size = 4;
+        static constexpr std::size_t bricks_per_axis = ChunkData::chunk_size / brick_size;
+        static_assert(bricks_per_axis * bricks_per_axis * bricks_per_axis == 64, "a brick per bit of a 64 bit mask");
+
+        // a bit per brick with at least a block in it
+        std::uint64_t bricks = 0;
+        // a bit per block of every brick
+        std::uint64_t blocks[64] = {};
+
+        // coordinates are local to the chunk
+        [[nodiscard]]
+        static constexpr std::size_t brick_of(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+        {
+            return ((x / brick_size) * bricks_per_axis + y / brick_size) * bricks_per_axis + z / brick_size;
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t bit_of(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+        {
+            return ((x % brick_size) * brick_size + y % brick_size) * brick_size + z % brick_size;
+        }
+
+        [[nodiscard]]
+        bool test(std::uint32_t x, std::uint32_t y, std::uint32_t z) const noexcept
+        {
+            return blocks[brick_of(x, y, z)] >> bit_of(x, y, z) & 1u;
+        }
+
+        void set(std::uint32_t x, std::uint32_t y, std::uint32_t z, bool occupied) noexcept
+        {
+            auto const brick = brick_of(x, y, z);
+            auto const bit = std::uint64_t { 1 } << bit_of(x, y, z);
+            blocks[brick] = occupied ? blocks[brick] | bit : blocks[brick] & ~bit;
+            bricks = blocks[brick] ? bricks | std::uint64_t { 1 } << brick : bricks & ~(std::uint64_t { 1 } << brick);
+        }
+    };
+
+} // namespace engine::components
\ No newline at end of file
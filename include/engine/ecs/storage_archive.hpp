@@ -0,0 +1,81 @@
+#pragma once
+
+#include <engine/binary_archive.hpp>
+#include <engine/errors/CorruptedData.hpp>
+
+#include <entt/entt.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine::ecs {
+
+    /**
+     * writes every T of the registry: the count, the packed entities and the components page by page
+     * trivially copyable components end up as one memcpy per page
+     */
+    template <typename T>
+    void save_storage(engine::BinaryOutputArchive &archive, entt::registry const &registry)
+    {
+        auto const *storage = registry.storage<T>();
+        std::uint64_t const count = storage ? storage->size() : 0u;
+        archive << count;
+        if (count == 0) return;
+
+        archive.write_span(std::span<entt::entity const>(storage->data(), count));
+
+        constexpr std::size_t page_size = entt::component_traits<T>::page_size;
+        if constexpr (page_size != 0) {
+            auto const *pages = storage->raw();
+            for (std::size_t i = 0; i < count; i += page_size)
+                archive.write_span(std::span<T const>(pages[i / page_size], std::min<std::size_t>(page_size, count - i)));
+        }
+    }
+
+    /**
+     * reads what save_storage wrote, entities keep their identifiers when they are free
+     * meant to be used on a registry that doesn't have any T yet
+     * @throws engine::errors::CorruptedData if the archive is truncated
+     */
+    template <typename T>
+    void load_storage(engine::BinaryInputArchive &archive, entt::registry &registry)
+    {
+        std::uint64_t count;
+        archive >> count;
+        if (count > archive.remaining() / sizeof(entt::entity)) {
+            SPDLOG_ERROR("binary archive has {} components but only {} bytes left", count, archive.remaining());
+            throw engine::errors::CorruptedData();
+        }
+
+        std::vector<entt::entity> entities(count);
+        archive.read_span(std::span(entities));
+        for (auto &entity : entities)
+            if (!registry.valid(entity))
+                entity = registry.create(entity);
+
+        auto &storage = registry.storage<T>();
+        if constexpr (entt::component_traits<T>::page_size == 0) {
+            storage.insert(entities.begin(), entities.end());
+        } else {
+            std::vector<T> components(count);
+            archive.read_span(std::span(components));
+            storage.insert(entities.begin(), entities.end(), components.begin());
+        }
+    }
+
+    template <typename... Ts>
+    void save_components(engine::BinaryOutputArchive &archive, entt::registry const &registry)
+    {
+        (save_storage<Ts>(archive, registry), ...);
+    }
+
+    template <typename... Ts>
+    void load_components(engine::BinaryInputArchive &archive, entt::registry &registry)
+    {
+        (load_storage<Ts>(archive, registry), ...);
+    }
+
+} // namespace engine::ecs
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <entt/entt.hpp>
+
+#include <chrono>
 #include <span>
 
 namespace engine::ecs {
@@ -44,8 +46,16 @@ namespace engine::ecs {
         }
     };
 
+    // in the registry's context while the systems run
+    struct Delta {
+        std::chrono::duration<double> delta;
+    };
+
     extern std::span<System const> const systems;
     extern std::span<SystemDependencies const> const systems_dependencies;
+
+    // in link order, none of them depends on another yet
+    void run_systems(entt::registry &registry, std::chrono::duration<double> delta);
 } // namespace engine::ecs
 
 #define CONCAT(a, b) a##b
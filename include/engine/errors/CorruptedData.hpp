@@ -0,0 +1,18 @@
+#ifndef ENGINE_ERRORS_CORRUPTED_DATA_HPP
+#define ENGINE_ERRORS_CORRUPTED_DATA_HPP
+
+#include <exception>
+
+namespace engine::errors {
+
+    class CorruptedData : public std::exception {
+
+    public:
+        explicit CorruptedData() noexcept;
+
+        char const *what() const noexcept override;
+    };
+
+}
+
+#endif
\ No newline at end of file
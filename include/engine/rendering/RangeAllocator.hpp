@@ -0,0 +1,64 @@
+#ifndef ENGINE_RENDERING_RANGE_ALLOCATOR_HPP
+#define ENGINE_RENDERING_RANGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <map>
+
+namespace engine::rendering {
+
+    /**
+     * first fit sub-allocator of a linear space such as a GPU buffer,
+     * offsets and sizes are in whatever unit the space is in,
+     * free ranges are kept sorted by offset and coalesced on free
+     */
+    class RangeAllocator {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        struct Stats {
+            std::size_t capacity;
+            std::size_t used;
+            std::size_t free_ranges;
+            std::size_t largest_free;
+
+            // 0 when all the free space is one range, approaches 1 as it gets scattered
+            [[nodiscard]]
+            float fragmentation() const noexcept
+            {
+                auto const free = capacity - used;
+                return free == 0 ? 0.0f : 1.0f - static_cast<float>(largest_free) / static_cast<float>(free);
+            }
+        };
+
+        explicit RangeAllocator(std::size_t capacity = 0);
+
+        /**
+         * @returns the offset of the range or npos if no free range is large enough
+         */
+        [[nodiscard]]
+        std::size_t allocate(std::size_t size);
+        void free(std::size_t offset, std::size_t size);
+
+        // the space is extended past its end, which is free
+        void grow(std::size_t capacity);
+        // everything is free again
+        void reset(std::size_t capacity);
+
+        [[nodiscard]]
+        std::size_t capacity() const noexcept { return m_capacity; }
+        [[nodiscard]]
+        std::size_t used() const noexcept { return m_used; }
+        [[nodiscard]]
+        Stats stats() const noexcept;
+
+    private:
+        // offset -> size
+        std::map<std::size_t, std::size_t> m_free;
+        std::size_t m_capacity = 0;
+        std::size_t m_used = 0;
+    };
+
+} // namespace engine::rendering
+
+#endif
\ No newline at end of file
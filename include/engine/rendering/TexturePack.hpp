@@ -0,0 +1,66 @@
+#ifndef ENGINE_RENDERING_TEXTURE_PACK_HPP
+#define ENGINE_RENDERING_TEXTURE_PACK_HPP
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::rendering {
+
+    /**
+     * the textures of a texture pack as the layers of an array, with every mip level
+     * built once and then mapped straight from the cache folder while the textures stay the same
+     */
+    class TexturePack {
+    public:
+        /**
+         * the images are decoded and filtered on worker threads when the cache is missing or out of date,
+         * it's keyed by a hash of the pack and the image files so nothing is decoded to check it
+         */
+        [[nodiscard]]
+        static TexturePack load(std::filesystem::path const &path);
+
+        [[nodiscard]]
+        std::uint32_t width() const noexcept { return m_width; }
+        [[nodiscard]]
+        std::uint32_t height() const noexcept { return m_height; }
+        [[nodiscard]]
+        std::uint32_t layers() const noexcept { return static_cast<std::uint32_t>(m_names.size()); }
+        [[nodiscard]]
+        std::uint32_t levels() const noexcept { return m_levels; }
+
+        // every layer of a mip level one after the other, 4 bytes per pixel red first
+        [[nodiscard]]
+        std::span<std::byte const> level(std::uint32_t) const noexcept;
+
+        [[nodiscard]]
+        std::optional<std::uint32_t> layer(std::string_view name) const noexcept;
+
+    private:
+        // false if the cache file is missing or was built from other textures
+        bool map_cache(std::string_view name, std::uint64_t key);
+        void build(std::span<std::filesystem::path const> files);
+        void save_cache(std::string_view name, std::uint64_t key) const;
+
+        // in layer order
+        std::vector<std::string> m_names;
+        std::uint32_t m_width = 0;
+        std::uint32_t m_height = 0;
+        std::uint32_t m_levels = 0;
+
+        // the pixels are in one of these, the mapped cache file or the ones just built
+        boost::interprocess::mapped_region m_mapping;
+        std::vector<std::byte> m_built;
+        std::span<std::byte const> m_pixels;
+    };
+
+} // namespace engine::rendering
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef ENGINE_RENDERING_BLOCK_HPP
 #define ENGINE_RENDERING_BLOCK_HPP
 
+#include <glm/ext/vector_uint3_sized.hpp>
 #include <glm/glm.hpp>
 
 namespace engine {
@@ -8,8 +9,9 @@ namespace engine {
         struct Vertex {
             glm::vec3 position {};
             glm::vec2 uv {};
-            glm::vec3 color { 0xFF, 0xFF, 0xFF };
-            glm::vec3 light {};
+            // normalized by the vertex layout
+            glm::u8vec3 color { 0xFF, 0xFF, 0xFF };
+            glm::u8vec3 light {};
             glm::uvec2 textures {};
         };
     } // namespace rendering
@@ -0,0 +1,98 @@
+#ifndef ENGINE_WITH_OPENGL
+#error "Engine is configured to not use OpenGL but this file was included"
+#endif
+
+#ifndef ENGINE_RENDERING_OPENGL_BUFFER_ARENA_HPP
+#define ENGINE_RENDERING_OPENGL_BUFFER_ARENA_HPP
+
+#include <glad/glad.h>
+
+#include <engine/rendering/RangeAllocator.hpp>
+#include <engine/rendering/opengl/StagingRing.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace engine::rendering::opengl {
+
+    /**
+     * one buffer object shared by many meshes, sub-allocated in elements of a fixed size,
+     * so they can all be drawn with a single vertex array and base vertex draws.
+     * allocations are referred to by handles because growing or compacting the arena moves them,
+     * along with the buffer object itself, see generation()
+     */
+    class BufferArena {
+    public:
+        using Handle = std::uint32_t;
+        static constexpr Handle null_handle = std::numeric_limits<Handle>::max();
+
+        // uploads go through staging, which must outlive the arena
+        BufferArena(StagingRing &staging, std::size_t element_size, std::size_t capacity);
+        BufferArena(BufferArena const &) = delete;
+        BufferArena &operator=(BufferArena const &) = delete;
+        ~BufferArena();
+
+        /**
+         * the arena grows to twice its size until the allocation fits
+         */
+        [[nodiscard]]
+        Handle allocate(std::size_t count);
+        void free(Handle);
+
+        /**
+         * changes the number of elements of an allocation, in place if it has the capacity for them,
+         * otherwise it moves to a range half again as large and its contents are lost
+         */
+        void resize(Handle, std::size_t count);
+
+        // gives back the unused capacity of allocations using less than half of it, looking at up to count of them
+        void trim(std::size_t count);
+
+        // count elements at the start of the allocation
+        void upload(Handle, void const *data, std::size_t count);
+
+        // moves every allocation to the start of a new buffer without its unused capacity, leaving a single free range
+        void compact();
+
+        [[nodiscard]]
+        std::size_t offset(Handle handle) const noexcept { return m_allocations[handle].offset; }
+        [[nodiscard]]
+        std::size_t count(Handle handle) const noexcept { return m_allocations[handle].count; }
+        [[nodiscard]]
+        std::size_t capacity(Handle handle) const noexcept { return m_allocations[handle].capacity; }
+
+        [[nodiscard]]
+        GLuint buffer() const noexcept { return m_buffer; }
+        // changes every time the buffer object is replaced, anything referencing it must be updated
+        [[nodiscard]]
+        std::uint32_t generation() const noexcept { return m_generation; }
+        [[nodiscard]]
+        RangeAllocator::Stats stats() const noexcept { return m_ranges.stats(); }
+
+    private:
+        struct Allocation {
+            std::size_t offset;
+            std::size_t count;
+            std::size_t capacity;
+        };
+
+        // grows the arena if needed
+        std::size_t allocate_range(std::size_t count);
+        void reallocate(std::size_t capacity);
+
+        StagingRing *m_staging;
+        std::size_t m_element_size;
+        GLuint m_buffer = 0;
+        std::uint32_t m_generation = 0;
+        RangeAllocator m_ranges;
+        std::vector<Allocation> m_allocations;
+        std::vector<Handle> m_free_handles;
+        // where trim() left off
+        std::size_t m_trim_cursor = 0;
+    };
+
+} // namespace engine::rendering::opengl
+
+#endif
\ No newline at end of file
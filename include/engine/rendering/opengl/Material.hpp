@@ -0,0 +1,74 @@
+#ifndef ENGINE_WITH_OPENGL
+#error "Engine is configured to not use OpenGL but this file was included"
+#endif
+
+#ifndef ENGINE_RENDERING_OPENGL_MATERIAL_HPP
+#define ENGINE_RENDERING_OPENGL_MATERIAL_HPP
+
+#include <engine/rendering/opengl/ProgramCache.hpp>
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace engine::rendering::opengl {
+
+    /**
+     * the shader stages of a material file and the features they can be built with
+     * every combination of features is a permutation, built the first time it's drawn with
+     */
+    class Material {
+    public:
+        // bit i enables the defines of the i-th feature
+        using Permutation = std::uint32_t;
+
+        struct Program {
+            GLuint id;
+            // declares the Draw block, so each of its draws is drawn on its own with its block bound
+            bool per_draw;
+        };
+
+        /**
+         * shows an error if the file isn't a valid material
+         */
+        [[nodiscard]]
+        static Material load(std::filesystem::path const &);
+
+        [[nodiscard]]
+        std::string_view type() const noexcept
+        {
+            return m_type;
+        }
+
+        // 0 if the material doesn't have it, so it can always be or'ed in
+        [[nodiscard]]
+        Permutation feature(std::string_view name) const noexcept;
+
+        /**
+         * builds the permutation through the cache the first time
+         * shows an error if it doesn't compile
+         */
+        [[nodiscard]]
+        Program const &program(ProgramCache const &, Permutation);
+
+        // deletes the programs built so far, they aren't deleted on destruction as that may be after the context is gone
+        void release() noexcept;
+
+    private:
+        std::filesystem::path m_path;
+        std::string m_type;
+        std::vector<ShaderStage> m_stages;
+        // always there, whatever the permutation
+        std::vector<std::string> m_defines;
+        std::vector<std::pair<std::string, std::vector<std::string>>> m_features;
+        std::unordered_map<Permutation, Program> m_programs;
+    };
+
+} // namespace engine::rendering::opengl
+
+#endif
\ No newline at end of file
@@ -5,15 +5,16 @@
 #ifndef ENGINE_RENDERING_OPENGL_MESH_HANDLE_HPP
 #define ENGINE_RENDERING_OPENGL_MESH_HANDLE_HPP
 
-#include <glad/glad.h>
+#include <engine/rendering/opengl/BufferArena.hpp>
 
 #include <cstdint>
 
 namespace engine::rendering::opengl {
+    // allocations in the renderer's vertex and index arenas
     struct MeshHandle {
-        GLuint vertex_buffer;
-        GLuint index_buffer;
-        std::uint32_t index_count;
+        BufferArena::Handle vertices = BufferArena::null_handle;
+        BufferArena::Handle indices = BufferArena::null_handle;
+        std::uint32_t index_count = 0;
     };
 }
 
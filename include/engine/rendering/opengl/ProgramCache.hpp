@@ -0,0 +1,50 @@
+#ifndef ENGINE_WITH_OPENGL
+#error "Engine is configured to not use OpenGL but this file was included"
+#endif
+
+#ifndef ENGINE_RENDERING_OPENGL_PROGRAM_CACHE_HPP
+#define ENGINE_RENDERING_OPENGL_PROGRAM_CACHE_HPP
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace engine::rendering::opengl {
+
+    struct ShaderStage {
+        GLenum type;
+        std::filesystem::path path;
+    };
+
+    /**
+     * builds every program of the engine, keeping their binaries in the cache folder
+     * a binary is keyed by a hash of the sources, the defines and the driver, so an edited shader
+     * or an updated driver never loads a stale one
+     */
+    class ProgramCache {
+    public:
+        // needs a current context, the driver is part of every key
+        ProgramCache();
+
+        /**
+         * the defines go right after the #version line of every stage
+         * shows an error if a stage doesn't compile or the program doesn't link
+         */
+        [[nodiscard]]
+        GLuint build(std::span<ShaderStage const> stages, std::span<std::string const> defines = {}) const;
+
+    private:
+        // 0 if it isn't cached or the driver rejects it
+        GLuint load(std::uint64_t key) const;
+        void save(GLuint program, std::uint64_t key) const;
+
+        std::uint64_t m_driver_hash;
+        bool m_binaries;
+    };
+
+} // namespace engine::rendering::opengl
+
+#endif
\ No newline at end of file
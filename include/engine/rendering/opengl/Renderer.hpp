@@ -8,13 +8,29 @@
 
 #include <SDL_video.h>
 #include <glad/glad.h>
+#include <glm/vec3.hpp>
 
 #include <engine/ecs/components/ChunkPosition.hpp>
 #include <engine/rendering/IRenderer.hpp>
 #include <engine/rendering/Mesh.hpp>
+#include <engine/rendering/opengl/BufferArena.hpp>
+#include <engine/rendering/opengl/Material.hpp>
 #include <engine/rendering/opengl/MeshHandle.hpp>
-
+#include <engine/rendering/opengl/ProgramCache.hpp>
+#include <engine/rendering/opengl/StagingRing.hpp>
+#include <engine/rendering/opengl/UniformBlocks.hpp>
+#include <engine/world/visibility.hpp>
+#include <math/occlusion.hpp>
+
+#include <entt/entity/fwd.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace engine {
     class Game;
@@ -28,19 +44,125 @@ namespace engine::rendering::opengl {
     private:
         std::optional<engine::sdl::Window::OpenGLContext> m_context;
         GLuint m_vao;
-        GLuint m_shader;
-        struct {
-            GLuint projection;
-            GLuint view;
-        } m_uniforms;
+        std::optional<engine::rendering::opengl::ProgramCache> m_programs;
+        // every chunk is drawn with it, the far ones with its far permutation
+        std::optional<engine::rendering::opengl::Material> m_terrain;
+        engine::rendering::opengl::Material::Permutation m_far_permutation;
+        // every layer of the texture pack
+        GLuint m_texture;
 
         struct ChunkMeshes {
             engine::rendering::opengl::MeshHandle translucent_mesh;
             engine::rendering::opengl::MeshHandle solid_mesh;
+            // every block is opaque, so it hides whatever is behind it
+            bool occluder = false;
+            engine::world::FaceConnectivity connectivity = engine::world::FaceConnectivity::open();
         };
 
+        // every upload goes through it, before the arenas so it outlives them
+        std::optional<engine::rendering::opengl::StagingRing> m_staging;
+        // every chunk mesh lives in these, so a whole pass is drawn with a single call
+        std::optional<engine::rendering::opengl::BufferArena> m_vertex_arena;
+        std::optional<engine::rendering::opengl::BufferArena> m_index_arena;
+        // of the arena buffers m_vao was last set up with
+        struct {
+            std::uint32_t vertices;
+            std::uint32_t indices;
+        } m_vao_generations;
+
         std::unordered_map<engine::components::ChunkPosition, ChunkMeshes> m_chunk_meshes;
         std::unordered_map<engine::components::ChunkPosition, engine::rendering::Mesh> m_translucent_mesh_data;
+        // dirty chunks waiting for their meshes to be uploaded, reused every frame
+        std::vector<std::pair<entt::entity, engine::components::ChunkPosition>> m_pending_meshes;
+
+        // chunks within the render distance nearest first and whether they're in the view frustum,
+        // only sorted again when the camera moves to another chunk or chunks are added
+        struct {
+            std::vector<float> x, y, z;
+            std::vector<std::uint8_t> visible;
+            std::vector<ChunkMeshes const *> meshes;
+            std::vector<engine::components::ChunkPosition> positions;
+            std::unordered_map<engine::components::ChunkPosition, std::uint32_t> indices;
+            std::vector<std::uint32_t> buckets;
+
+            // breadth first search of the chunks that can be seen through the others
+            std::vector<std::uint32_t> queue;
+            std::vector<std::uint8_t> reached;
+            std::vector<engine::Sides> entered;
+            std::vector<engine::Sides> travelled;
+
+            bool stale = true;
+            engine::components::ChunkPosition center;
+            int horizontal_distance;
+            int vertical_distance;
+        } m_culling;
+
+        math::OcclusionBuffer m_occlusion;
+
+        // headless rendering draws here instead of to the window
+        struct {
+            GLuint framebuffer = 0;
+            GLuint color = 0;
+            GLuint depth = 0;
+            std::uint64_t frames = 0;
+            std::chrono::steady_clock::time_point start;
+        } m_offscreen;
+
+        // arguments of glMultiDrawElementsBaseVertex, reused every frame
+        struct DrawList {
+            std::vector<GLsizei> counts;
+            std::vector<void const *> offsets;
+            std::vector<GLint> base_vertices;
+            // of each draw in m_uniforms.draw_blocks, only when the program takes a Draw block
+            std::vector<std::uint32_t> blocks;
+
+            void clear() noexcept
+            {
+                counts.clear();
+                offsets.clear();
+                base_vertices.clear();
+                blocks.clear();
+            }
+        };
+        // the draws of a pass sharing a program, each one switches the program once
+        struct Batch {
+            engine::rendering::opengl::Material::Program const *program;
+            DrawList draws;
+        };
+        struct Pass {
+            // reused every frame, only the first used ones are drawn
+            std::vector<Batch> batches;
+            std::size_t used = 0;
+
+            void clear() noexcept
+            {
+                for (std::size_t i = 0; i < used; ++i)
+                    batches[i].draws.clear();
+                used = 0;
+            }
+
+            /**
+             * the batch drawn with the program
+             * an ordered pass is drawn in the order draws were added, so only consecutive draws are batched
+             */
+            DrawList &batch(engine::rendering::opengl::Material::Program const &, bool ordered);
+        };
+        Pass m_translucent_pass;
+        Pass m_solid_pass;
+
+        // the frame block and the draw blocks of the frame are written to the staging ring every frame and bound from there
+        struct {
+            // of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, every block starts at a multiple of it
+            std::size_t alignment;
+            std::size_t draw_stride;
+            // packed draw_stride apart, written to the ring in slices that fit in it
+            std::vector<std::byte> draw_blocks;
+            std::uint32_t draw_count;
+            std::uint32_t blocks_per_slice;
+            // in the staging ring, of every slice this frame
+            std::vector<std::size_t> slices;
+            std::chrono::steady_clock::time_point start;
+        } m_uniforms;
 
     public:
         engine::sdl::Window create_window(char const *title, int x, int y, int w, int h, uint32_t flags) override;
@@ -55,8 +177,22 @@ namespace engine::rendering::opengl {
         ~Renderer() override;
 
     private:
-        void setup_shader();
+        void setup_materials();
         void setup_texture();
+        void setup_vertex_array();
+        void setup_offscreen();
+        // saves the offscreen framebuffer to the cache folder, waits for the frame to finish rendering
+        void dump_frame() const;
+        // meshes a chunk and uploads its meshes, returns the bytes uploaded
+        std::size_t mesh_chunk(entt::registry &, entt::entity chunk, engine::components::ChunkPosition const &);
+        void sort_chunks(engine::components::ChunkPosition center);
+        void cull_unreachable(std::uint32_t start);
+
+        void upload_mesh(engine::rendering::opengl::MeshHandle &, engine::rendering::Mesh::vertex_vector const &, engine::rendering::Mesh::index_vector const &);
+        void add_draw(DrawList &, engine::rendering::opengl::MeshHandle const &) const;
+        // returns the index of the block
+        std::uint32_t add_draw_block(engine::rendering::opengl::DrawBlock const &);
+        void draw_pass(Pass const &) const;
     };
 }
 
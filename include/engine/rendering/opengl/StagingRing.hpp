@@ -0,0 +1,68 @@
+#ifndef ENGINE_WITH_OPENGL
+#error "Engine is configured to not use OpenGL but this file was included"
+#endif
+
+#ifndef ENGINE_RENDERING_OPENGL_STAGING_RING_HPP
+#define ENGINE_RENDERING_OPENGL_STAGING_RING_HPP
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+
+namespace engine::rendering::opengl {
+
+    /**
+     * ring buffer every upload is written through before being copied to its destination buffer
+     * the ring is mapped unsynchronized, so writing never waits on the driver, instead each region
+     * written is fenced and a region is only written again once the gpu is done copying from it
+     */
+    class StagingRing {
+    public:
+        explicit StagingRing(std::size_t capacity);
+        StagingRing(StagingRing const &) = delete;
+        StagingRing &operator=(StagingRing const &) = delete;
+        ~StagingRing();
+
+        // uploads larger than the whole ring go straight to the destination
+        void copy(GLuint destination, std::size_t offset, void const *data, std::size_t size);
+
+        /**
+         * writes data that is read straight from the ring, like uniform blocks bound by offset
+         * it stays there until the end_frame() after it's used, size must fit in the ring
+         * @returns the offset it was written at, a multiple of alignment
+         */
+        [[nodiscard]]
+        std::size_t write(void const *data, std::size_t size, std::size_t alignment);
+
+        [[nodiscard]]
+        GLuint buffer() const noexcept
+        {
+            return m_buffer;
+        }
+
+        // fences what was written since the last call, once a frame
+        void end_frame();
+
+    private:
+        struct Region {
+            std::size_t begin;
+            std::size_t end;
+            GLsync fence;
+        };
+
+        // waits for the gpu to be done with every region overlapping [begin, end)
+        void reserve(std::size_t begin, std::size_t end);
+
+        GLuint m_buffer = 0;
+        std::size_t m_capacity;
+        // written but not yet fenced
+        std::size_t m_open_begin = 0;
+        std::size_t m_head = 0;
+        // oldest first
+        std::deque<Region> m_fenced;
+    };
+
+} // namespace engine::rendering::opengl
+
+#endif
\ No newline at end of file
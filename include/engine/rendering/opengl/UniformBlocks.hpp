@@ -0,0 +1,47 @@
+#ifndef ENGINE_WITH_OPENGL
+#error "Engine is configured to not use OpenGL but this file was included"
+#endif
+
+#ifndef ENGINE_RENDERING_OPENGL_UNIFORM_BLOCKS_HPP
+#define ENGINE_RENDERING_OPENGL_UNIFORM_BLOCKS_HPP
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+
+namespace engine::rendering::opengl {
+
+    // std140 layouts of the uniform blocks every shader of the engine may declare, they must match the glsl ones
+
+    // layout(std140) uniform Frame, the same for every draw of a frame
+    struct FrameBlock {
+        static constexpr GLuint binding = 0;
+
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 camera_position;
+        // seconds since the renderer started
+        float time;
+    };
+
+    // layout(std140) uniform Draw, a draw is only given one when its program declares it
+    struct DrawBlock {
+        static constexpr GLuint binding = 1;
+
+        // chunk meshes are in chunk coordinates, this is where the chunk starts
+        glm::vec3 chunk_origin;
+        // 0 near, 1 drawn with the far permutation
+        float lod;
+        // from 0 to 1, 1 fully shown
+        float fade;
+        float padding[3];
+    };
+
+    static_assert(sizeof(FrameBlock) == 144 && offsetof(FrameBlock, projection) == 64 && offsetof(FrameBlock, camera_position) == 128 && offsetof(FrameBlock, time) == 140);
+    static_assert(sizeof(DrawBlock) == 32 && offsetof(DrawBlock, lod) == 12 && offsetof(DrawBlock, fade) == 16);
+
+} // namespace engine::rendering::opengl
+
+#endif
\ No newline at end of file
@@ -8,22 +8,45 @@
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_free.hpp>
 
+namespace engine::serialization {
+    /**
+     * lists the members of a type, specialized by SERIALIZABLE_COMPONENT
+     * members<T>::visit(component, visitor) calls visitor with every member in declaration order
+     */
+    template <typename T>
+    struct members {
+        static constexpr bool declared = false;
+    };
+} // namespace engine::serialization
+
 #define SERIALIZE_COMPONENT_IMPL(r, op, member) archive op boost::serialization::make_nvp(BOOST_PP_STRINGIZE(member), component.member);
+#define VISIT_COMPONENT_IMPL(r, visitor, member) visitor(component.member);
 
-#define SERIALIZABLE_COMPONENT(T, ...)                                                                             \
-    namespace boost::serialization {                                                                               \
-        template <class Archive>                                                                                   \
-        void save([[maybe_unused]] Archive &archive, [[maybe_unused]] T const &component, unsigned int const)      \
-        {                                                                                                          \
-            __VA_OPT__(BOOST_PP_SEQ_FOR_EACH(SERIALIZE_COMPONENT_IMPL, <<, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__))) \
-        }                                                                                                          \
-                                                                                                                   \
-        template <class Archive>                                                                                   \
-        void load([[maybe_unused]] Archive &archive, [[maybe_unused]] T &component, unsigned int const)            \
-        {                                                                                                          \
-            __VA_OPT__(BOOST_PP_SEQ_FOR_EACH(SERIALIZE_COMPONENT_IMPL, >>, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__))) \
-        }                                                                                                          \
-    }                                                                                                              \
-    BOOST_SERIALIZATION_SPLIT_FREE(T)
+#define SERIALIZABLE_COMPONENT(T, ...)                                                                              \
+    namespace boost::serialization {                                                                                \
+        template <class Archive>                                                                                    \
+        void save([[maybe_unused]] Archive &archive, [[maybe_unused]] T const &component, unsigned int const)       \
+        {                                                                                                           \
+            __VA_OPT__(BOOST_PP_SEQ_FOR_EACH(SERIALIZE_COMPONENT_IMPL, <<, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)))  \
+        }                                                                                                           \
+                                                                                                                    \
+        template <class Archive>                                                                                    \
+        void load([[maybe_unused]] Archive &archive, [[maybe_unused]] T &component, unsigned int const)             \
+        {                                                                                                           \
+            __VA_OPT__(BOOST_PP_SEQ_FOR_EACH(SERIALIZE_COMPONENT_IMPL, >>, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)))  \
+        }                                                                                                           \
+    }                                                                                                               \
+    BOOST_SERIALIZATION_SPLIT_FREE(T)                                                                               \
+                                                                                                                    \
+    template <>                                                                                                     \
+    struct engine::serialization::members<T> {                                                                      \
+        static constexpr bool declared = true;                                                                      \
+                                                                                                                    \
+        template <typename Component, typename Visitor>                                                             \
+        static void visit([[maybe_unused]] Component &component, [[maybe_unused]] Visitor &&visitor)                \
+        {                                                                                                           \
+            __VA_OPT__(BOOST_PP_SEQ_FOR_EACH(VISIT_COMPONENT_IMPL, visitor, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__))) \
+        }                                                                                                           \
+    };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef ENGINE_SYSTEM_ASYNC_IO_HPP
+#define ENGINE_SYSTEM_ASYNC_IO_HPP
+
+#include <engine/nonnull.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace engine::system {
+
+    /**
+     * positioned reads and writes completed in the background
+     *
+     * requests are queued and only handed to the backend on submit(), so a frame worth of them
+     * goes out in one batch. callbacks run on an I/O thread, never on the one that queued them.
+     * the files must stay open until their requests complete.
+     */
+    class IAsyncIO {
+    public:
+        // the bytes are only valid during the call, there are fewer than requested at the end of the file
+        using ReadCallback = std::function<void(std::error_code, std::span<std::byte const>)>;
+        using WriteCallback = std::function<void(std::error_code)>;
+
+        virtual void queue_read(engine::nonnull<std::FILE>, std::uint64_t offset, std::size_t size, ReadCallback) = 0;
+        virtual void queue_write(engine::nonnull<std::FILE>, std::uint64_t offset, std::vector<std::byte> data, WriteCallback) = 0;
+
+        virtual void submit() = 0;
+
+        // blocks until every submitted request completed
+        virtual void wait_idle() = 0;
+
+        [[nodiscard]]
+        std::future<std::vector<std::byte>> read(engine::nonnull<std::FILE>, std::uint64_t offset, std::size_t size);
+
+        [[nodiscard]]
+        std::future<void> write(engine::nonnull<std::FILE>, std::uint64_t offset, std::vector<std::byte> data);
+
+        virtual ~IAsyncIO() = default;
+    };
+
+    /**
+     * the fastest backend available, io_uring on Linux, a thread pool elsewhere
+     * @param queue_depth how many requests can be in flight at once
+     */
+    [[nodiscard]]
+    std::unique_ptr<IAsyncIO> make_async_io(std::size_t queue_depth = 128);
+
+    /**
+     * portable backend doing blocking reads and writes on a few threads
+     */
+    [[nodiscard]]
+    std::unique_ptr<IAsyncIO> make_thread_pool_io(std::uint32_t threads);
+
+} // namespace engine::system
+
+#endif
\ No newline at end of file
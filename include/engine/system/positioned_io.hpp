@@ -0,0 +1,31 @@
+#ifndef ENGINE_SYSTEM_POSITIONED_IO_HPP
+#define ENGINE_SYSTEM_POSITIONED_IO_HPP
+
+#include <engine/nonnull.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+namespace engine::system {
+    /**
+     * reads up to data.size() bytes at the given offset without moving the file position
+     * returns the amount of bytes read, which is only less than requested at the end of the file
+     */
+    [[nodiscard]]
+    std::size_t read_at(engine::nonnull<std::FILE>, std::uint64_t offset, std::span<std::byte> data);
+
+    /**
+     * writes all of data at the given offset without moving the file position
+     * the file must not have pending buffered writes
+     */
+    void write_at(engine::nonnull<std::FILE>, std::uint64_t offset, std::span<std::byte const> data);
+
+    /**
+     * flushes the file data to the storage device
+     */
+    void sync(engine::nonnull<std::FILE>);
+} // namespace engine::system
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef ENGINE_WORLD_CHUNK_CODEC_HPP
+#define ENGINE_WORLD_CHUNK_CODEC_HPP
+
+#include <engine/ecs/components/ChunkData.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace engine::world {
+
+    enum class Compression : std::uint8_t {
+        none = 0,
+        // runs of identical blocks, most chunks are a handful of long runs
+        rle = 1,
+    };
+
+    // every stored chunk starts with this, followed by an engine::BinaryOutputArchive of the blocks,
+    // as they are or run length encoded, and then their engine::BlockPayloads
+    struct PayloadHeader {
+        static constexpr std::size_t size = 8;
+
+        Compression compression;
+        std::uint32_t decoded_size;
+    };
+
+    [[nodiscard]]
+    std::vector<std::byte> encode_chunk(engine::components::ChunkData const &, Compression);
+
+    /**
+     * @throws engine::errors::CorruptedData if the payload can't be decoded
+     */
+    void decode_chunk(std::span<std::byte const> payload, engine::components::ChunkData &);
+
+    /**
+     * blocks of an uncompressed payload that is already in the in-memory layout,
+     * so they can be used in place without decoding, only the block payloads are decoded
+     * @returns nullptr if the payload needs to be decoded with decode_chunk
+     * @throws engine::errors::CorruptedData if the payload can't be decoded
+     */
+    [[nodiscard]]
+    engine::Block const *view_chunk(std::span<std::byte const> payload, engine::BlockPayloads &payloads);
+
+    /**
+     * @throws engine::errors::CorruptedData if the payload header is truncated
+     */
+    [[nodiscard]]
+    PayloadHeader read_payload_header(std::span<std::byte const> payload);
+
+} // namespace engine::world
+
+#endif
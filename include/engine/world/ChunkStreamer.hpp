@@ -0,0 +1,101 @@
+#ifndef ENGINE_WORLD_CHUNK_STREAMER_HPP
+#define ENGINE_WORLD_CHUNK_STREAMER_HPP
+
+#include <engine/ecs/components/ChunkData.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+#include <engine/ecs/components/MappedChunkData.hpp>
+#include <engine/system/async_io.hpp>
+#include <engine/world/RegionStorage.hpp>
+#include <utils/thread_pool.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+namespace engine::world {
+
+    /**
+     * loads chunks from a RegionStorage without blocking the game thread
+     * the chunks are found, read and decoded in the background, the results are collected with poll()
+     */
+    class ChunkStreamer {
+    public:
+        struct Result {
+            engine::components::ChunkPosition position;
+            // std::monostate if the chunk was never saved or couldn't be decoded
+            std::variant<std::monostate, std::unique_ptr<engine::components::ChunkData>, engine::components::MappedChunkData> chunk;
+        };
+
+        // the chunks are found and decoded on their own threads, the I/O threads only complete the reads
+        ChunkStreamer(RegionStorage &storage, engine::system::IAsyncIO &io, std::uint32_t threads = 2)
+            : m_storage(&storage)
+            , m_io(&io)
+            , m_pool(&ChunkStreamer::work, threads)
+        {
+        }
+
+        ChunkStreamer(ChunkStreamer const &) = delete;
+        ChunkStreamer &operator=(ChunkStreamer const &) = delete;
+
+        ~ChunkStreamer();
+
+        /**
+         * queues the chunk to be loaded, does nothing if it is already pending
+         * the loads go out in one batch on the next poll()
+         */
+        void request(engine::components::ChunkPosition const &);
+
+        /**
+         * submits the queued loads and returns the loads that finished since the last call
+         */
+        [[nodiscard]]
+        std::vector<Result> poll();
+
+        [[nodiscard]]
+        bool is_pending(engine::components::ChunkPosition const &position) const noexcept
+        {
+            return m_pending.contains(position);
+        }
+
+        [[nodiscard]]
+        std::size_t pending() const noexcept
+        {
+            return m_pending.size();
+        }
+
+    private:
+        // on the pool, without a payload the chunk is found and its read queued, with one it is decoded
+        static void work(ChunkStreamer *, engine::components::ChunkPosition, std::optional<std::vector<std::byte>> payload);
+        void load(engine::components::ChunkPosition const &);
+        void decode(engine::components::ChunkPosition const &, std::span<std::byte const> payload);
+        void push_result(Result);
+
+        RegionStorage *m_storage;
+        engine::system::IAsyncIO *m_io;
+
+        // only touched by the game thread
+        std::unordered_set<engine::components::ChunkPosition> m_pending;
+
+        // filled by the pool and the I/O threads
+        std::mutex m_mutex;
+        std::condition_variable m_idle;
+        std::vector<Result> m_finished;
+        // requested but without a result yet
+        std::size_t m_loading = 0;
+        // set by the destructor, the reads queued after it can't wait for the next poll()
+        bool m_stopping = false;
+
+        // last, its threads call back into the streamer
+        utils::thread_pool<void, ChunkStreamer *, engine::components::ChunkPosition, std::optional<std::vector<std::byte>>> m_pool;
+    };
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef ENGINE_WORLD_DIMENSION_HPP
+#define ENGINE_WORLD_DIMENSION_HPP
+
+#include <engine/BlockType.hpp>
+#include <engine/Sides.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+#include <engine/ecs/components/Heightmap.hpp>
+#include <engine/named_storage.hpp>
+#include <engine/world/ChunkStreamer.hpp>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace engine::world {
+
+    struct RaycastHit {
+        // world coordinates of the block
+        glm::ivec3 position;
+        engine::Block block;
+        // the face the ray went in through, NONE if it started inside the block
+        engine::Sides face;
+        // along the ray, in blocks
+        float distance;
+    };
+
+    /**
+     * the chunks and entities of one dimension
+     * each dimension owns its registry, chunk index and heightmaps, so different dimensions can be
+     * updated from different threads without sharing anything but the read only block types
+     */
+    class Dimension {
+    public:
+        Dimension(std::int32_t id, engine::named_storage<engine::BlockType> const &block_types);
+
+        // the registry signals point back to us
+        Dimension(Dimension const &) = delete;
+        Dimension &operator=(Dimension const &) = delete;
+
+        [[nodiscard]]
+        std::int32_t id() const noexcept
+        {
+            return m_id;
+        }
+
+        [[nodiscard]]
+        entt::registry &registry() noexcept
+        {
+            return m_registry;
+        }
+
+        [[nodiscard]]
+        entt::registry const &registry() const noexcept
+        {
+            return m_registry;
+        }
+
+        // entt::null if the chunk isn't loaded
+        [[nodiscard]]
+        entt::entity chunk(engine::components::ChunkPosition const &position) const noexcept
+        {
+            auto const it = m_chunks.find(position);
+            return it == m_chunks.end() ? entt::null : it->second;
+        }
+
+        [[nodiscard]]
+        auto const &chunks() const noexcept
+        {
+            return m_chunks;
+        }
+
+        /**
+         * builds the Occupancy of a chunk and puts its blocks in the heightmaps of its column
+         * to be called once its ChunkData or MappedChunkData is in place, and again when it's replaced
+         */
+        void chunk_loaded(entt::entity chunk);
+
+        // entity with the Heightmap of a column, entt::null if none of its chunks are loaded
+        [[nodiscard]]
+        entt::entity column(engine::components::ColumnPosition const &position) const noexcept
+        {
+            auto const it = m_columns.find(position);
+            return it == m_columns.end() ? entt::null : it->second;
+        }
+
+        /**
+         * world y of the topmost block of a kind at a world (x, z)
+         * @returns Heightmap::none if no loaded chunk has such a block there
+         */
+        [[nodiscard]]
+        std::int32_t height(engine::components::Heightmap::Kind, std::int32_t x, std::int32_t z) const noexcept;
+
+        // nullptr if its chunk isn't loaded
+        [[nodiscard]]
+        engine::Block const *block(glm::ivec3 position) const noexcept;
+
+        /**
+         * replaces a block and its payload, tagging its chunk as modified and the meshes that can see it as dirty
+         * @returns false if its chunk isn't loaded
+         */
+        bool set_block(glm::ivec3 position, engine::Block block, entt::id_type payload = entt::null);
+
+        /**
+         * first non-air block along a ray, walking the grid one block at a time (Amanatides & Woo)
+         * empty chunks and empty 4x4x4 bricks are crossed in a single step, chunks that aren't loaded count as empty
+         * doesn't modify anything, any number of threads can cast rays while the dimension isn't being updated
+         * @param direction doesn't need to be normalized
+         */
+        [[nodiscard]]
+        std::optional<RaycastHit> raycast(glm::vec3 origin, glm::vec3 direction, float max_distance) const noexcept;
+
+        // streamed chunks waiting to be added on the next update
+        void deliver(ChunkStreamer::Result result)
+        {
+            m_arrived.push_back(std::move(result));
+        }
+
+        [[nodiscard]]
+        std::vector<ChunkStreamer::Result> take_arrived() noexcept
+        {
+            return std::exchange(m_arrived, {});
+        }
+
+        // nothing arrived and nothing moves, the update can be skipped
+        [[nodiscard]]
+        bool is_idle() const noexcept;
+
+    private:
+        void on_chunk_construct(entt::registry &, entt::entity chunk);
+        void on_chunk_destroy(entt::registry &, entt::entity chunk);
+
+        [[nodiscard]]
+        engine::components::Heightmap::Mask heightmap_mask(engine::Block block) const noexcept;
+
+        // topmost block of a kind at or below a world y, going through the loaded chunks of the column
+        [[nodiscard]]
+        std::int32_t find_height(engine::components::ColumnPosition const &, engine::components::Heightmap const &, engine::components::Heightmap::Kind, std::uint32_t x, std::uint32_t z, std::int32_t from) const noexcept;
+
+        std::int32_t m_id;
+        engine::named_storage<engine::BlockType> const *m_block_types;
+        entt::registry m_registry;
+        std::unordered_map<engine::components::ChunkPosition, entt::entity> m_chunks;
+        std::unordered_map<engine::components::ColumnPosition, entt::entity> m_columns;
+        std::vector<ChunkStreamer::Result> m_arrived;
+    };
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
@@ -0,0 +1,184 @@
+#ifndef ENGINE_WORLD_REGION_FILE_HPP
+#define ENGINE_WORLD_REGION_FILE_HPP
+
+#include <engine/File.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace engine::world {
+
+    struct RegionPosition {
+        std::int32_t x {};
+        std::int32_t y {};
+        std::int32_t z {};
+        std::int32_t dimension {};
+
+        friend constexpr bool operator==(RegionPosition const &, RegionPosition const &) noexcept = default;
+    };
+
+    /**
+     * a fixed grid of chunks stored in a single file
+     *
+     * the file starts with a header and an offset table with one entry per chunk,
+     * followed by the chunk payloads, each one a whole number of sectors long.
+     * sectors match the block size of the underlying filesystem so that rewriting a chunk
+     * never touches a block shared with another one.
+     */
+    class RegionFile {
+    public:
+        // chunks along the x and z axes
+        static constexpr std::int32_t width = 32;
+        // chunks along the y axis
+        static constexpr std::int32_t height = 16;
+        static constexpr std::size_t chunk_count = static_cast<std::size_t>(width * width * height);
+
+        // used when the filesystem's block size isn't a valid sector size
+        static constexpr std::size_t default_sector_size = 4096;
+
+        [[nodiscard]]
+        static constexpr bool valid_sector_size(std::size_t sector_size) noexcept
+        {
+            return std::has_single_bit(sector_size) && sector_size >= 512 && sector_size <= 64 * 1024;
+        }
+
+        [[nodiscard]]
+        static RegionPosition region_of(engine::components::ChunkPosition const &) noexcept;
+
+        /**
+         * index of the chunk in the offset table of its region
+         */
+        [[nodiscard]]
+        static std::size_t index_of(engine::components::ChunkPosition const &) noexcept;
+
+        /**
+         * opens the region at path, creating an empty one if it doesn't exist
+         * @throws std::system_error on I/O errors
+         * @throws engine::errors::CorruptedData if the header is invalid
+         */
+        [[nodiscard]]
+        static RegionFile open(std::filesystem::path const &path);
+
+        [[nodiscard]]
+        bool contains(std::size_t index) const noexcept
+        {
+            return m_entries[index].size != 0;
+        }
+
+        /**
+         * @returns the stored payload or std::nullopt if the chunk was never written
+         */
+        [[nodiscard]]
+        std::optional<std::vector<std::byte>> read(std::size_t index) const;
+
+        struct Extent {
+            std::uint64_t offset;
+            std::uint32_t size;
+        };
+
+        /**
+         * where the payload lives in the file, for reading it some other way
+         * @returns std::nullopt if the chunk was never written
+         */
+        [[nodiscard]]
+        std::optional<Extent> locate(std::size_t index) const noexcept
+        {
+            auto const entry = m_entries[index];
+            if (entry.size == 0) return std::nullopt;
+            return Extent { std::uint64_t { entry.sector } * m_sector_size, entry.size };
+        }
+
+        [[nodiscard]]
+        std::FILE *file() const noexcept
+        {
+            return m_file.get();
+        }
+
+        struct MappedPayload {
+            // keeps the bytes alive after the region is remapped or closed
+            std::shared_ptr<boost::interprocess::mapped_region const> mapping;
+            std::span<std::byte const> bytes;
+        };
+
+        /**
+         * the stored payload straight from a read only mapping of the file, no copies involved
+         * the bytes change if the chunk is written again, don't keep them around past that
+         * @returns std::nullopt if the chunk was never written
+         */
+        [[nodiscard]]
+        std::optional<MappedPayload> map(std::size_t index);
+
+        /**
+         * stores the payload, reusing the chunk sectors when it still fits
+         */
+        void write(std::size_t index, std::span<std::byte const> payload);
+
+        void erase(std::size_t index);
+
+        /**
+         * makes the written payloads durable
+         */
+        void flush();
+
+        [[nodiscard]]
+        std::size_t sector_size() const noexcept
+        {
+            return m_sector_size;
+        }
+
+    private:
+        struct Entry {
+            // first sector of the payload, 0 if absent (the header always owns sector 0)
+            std::uint32_t sector;
+            // payload size in bytes, 0 if absent
+            std::uint32_t size;
+        };
+
+        RegionFile(engine::File file, std::size_t sector_size) noexcept;
+
+        [[nodiscard]]
+        std::size_t sectors_for(std::size_t bytes) const noexcept
+        {
+            return (bytes + m_sector_size - 1) / m_sector_size;
+        }
+
+        [[nodiscard]]
+        std::uint32_t allocate(std::size_t sectors);
+        void release(std::uint32_t first, std::size_t sectors) noexcept;
+        void mark_used(std::uint32_t first, std::size_t sectors) noexcept;
+
+        void write_entry(std::size_t index, Entry);
+
+        engine::File m_file;
+        std::size_t m_sector_size;
+        std::vector<Entry> m_entries;
+        std::vector<bool> m_used_sectors;
+        // covers the file as it was when mapped, replaced once it grows past that
+        std::shared_ptr<boost::interprocess::mapped_region const> m_mapping;
+    };
+
+} // namespace engine::world
+
+#include <boost/container_hash/hash.hpp>
+
+namespace std {
+
+    template <>
+    struct hash<engine::world::RegionPosition> {
+        std::size_t operator()(engine::world::RegionPosition const &position) const noexcept
+        {
+            std::int32_t const arr[] = { position.x, position.y, position.z, position.dimension };
+            return boost::hash_value(arr);
+        }
+    };
+
+}
+
+#endif
\ No newline at end of file
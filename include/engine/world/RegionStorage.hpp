@@ -0,0 +1,105 @@
+#ifndef ENGINE_WORLD_REGION_STORAGE_HPP
+#define ENGINE_WORLD_REGION_STORAGE_HPP
+
+#include <engine/ecs/components/ChunkData.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+#include <engine/ecs/components/MappedChunkData.hpp>
+#include <engine/world/ChunkCodec.hpp>
+#include <engine/world/RegionFile.hpp>
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace engine::world {
+
+    /**
+     * a world saved as a directory of region files, one subdirectory per dimension
+     * regions are opened the first time one of their chunks is accessed and kept open
+     * safe to use from several threads
+     */
+    class RegionStorage {
+    public:
+        explicit RegionStorage(std::filesystem::path directory, Compression compression = Compression::rle);
+
+        void save(engine::components::ChunkPosition const &, engine::components::ChunkData const &);
+
+        // stores a payload made by encode_chunk
+        void save_payload(engine::components::ChunkPosition const &, std::span<std::byte const> payload);
+
+        /**
+         * @returns false if the chunk was never saved, chunk is left untouched in that case
+         */
+        [[nodiscard]]
+        bool load(engine::components::ChunkPosition const &, engine::components::ChunkData &chunk);
+
+        /**
+         * maps the chunk blocks from its region file instead of decoding them,
+         * only possible for chunks saved uncompressed
+         * @returns std::nullopt if the chunk was never saved or has to be loaded with load()
+         */
+        [[nodiscard]]
+        std::optional<engine::components::MappedChunkData> map(engine::components::ChunkPosition const &);
+
+        struct Location {
+            std::FILE *file;
+            RegionFile::Extent extent;
+        };
+
+        /**
+         * where the chunk payload is stored, the file stays open as long as the storage
+         * the extent is pinned until release() is called with the same position, saving or erasing
+         * the chunk blocks until then so the sectors aren't reused while they are read
+         * @returns std::nullopt if the chunk was never saved, nothing is pinned in that case
+         */
+        [[nodiscard]]
+        std::optional<Location> locate(engine::components::ChunkPosition const &);
+
+        // once for every location returned by locate()
+        void release(engine::components::ChunkPosition const &);
+
+        void erase(engine::components::ChunkPosition const &);
+
+        /**
+         * makes every save so far durable
+         */
+        void flush();
+
+        [[nodiscard]]
+        Compression compression() const noexcept
+        {
+            return m_compression;
+        }
+
+        [[nodiscard]]
+        std::filesystem::path const &directory() const noexcept
+        {
+            return m_directory;
+        }
+
+    private:
+        [[nodiscard]]
+        std::filesystem::path region_path(RegionPosition const &) const;
+
+        // nullptr if the region doesn't exist on disk
+        [[nodiscard]]
+        RegionFile *find_region(RegionPosition const &);
+        [[nodiscard]]
+        RegionFile &region(RegionPosition const &);
+
+        std::filesystem::path m_directory;
+        Compression m_compression;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<RegionPosition, RegionFile> m_regions;
+        // how many times each chunk was located and not yet released
+        std::unordered_map<engine::components::ChunkPosition, unsigned> m_pinned;
+        std::condition_variable m_unpinned;
+    };
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef ENGINE_WORLD_WORLD_SAVER_HPP
+#define ENGINE_WORLD_WORLD_SAVER_HPP
+
+#include <engine/File.hpp>
+#include <engine/ecs/components/ChunkData.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+#include <engine/world/RegionStorage.hpp>
+
+#include <entt/entity/fwd.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace engine::world {
+
+    /**
+     * saves the chunks tagged with engine::components::Modified from a background thread
+     *
+     * every batch is first written to a journal next to the region files and committed with
+     * a separate record, only then the region files are updated. a batch interrupted before
+     * its commit is dropped, one interrupted after it is replayed when the world is opened again.
+     */
+    class WorldSaver {
+    public:
+        /**
+         * replays the journal left by an interrupted save
+         * @throws std::system_error on I/O errors
+         */
+        explicit WorldSaver(RegionStorage &storage);
+
+        WorldSaver(WorldSaver const &) = delete;
+        WorldSaver &operator=(WorldSaver const &) = delete;
+
+        // finishes the pending saves
+        ~WorldSaver();
+
+        /**
+         * copies the modified chunks and clears their tag, the copies are written in the background
+         * @returns the amount of chunks queued
+         */
+        std::size_t save_modified(entt::registry &);
+
+        // blocks until everything queued so far is in the region files
+        void wait_idle();
+
+    private:
+        using Batch = std::vector<std::pair<engine::components::ChunkPosition, std::unique_ptr<engine::components::ChunkData>>>;
+
+        void thread_main();
+        void write(Batch const &);
+        void replay();
+        void retire_journal();
+
+        [[nodiscard]]
+        std::size_t align(std::size_t size) const noexcept
+        {
+            return (size + m_block_size - 1) / m_block_size * m_block_size;
+        }
+
+        RegionStorage *m_storage;
+        engine::File m_journal;
+        std::size_t m_block_size;
+        std::uint64_t m_sequence = 0;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<Batch> m_batches;
+        bool m_writing = false;
+        bool m_stopping = false;
+
+        std::thread m_thread;
+    };
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
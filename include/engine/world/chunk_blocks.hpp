@@ -0,0 +1,65 @@
+#ifndef ENGINE_WORLD_CHUNK_BLOCKS_HPP
+#define ENGINE_WORLD_CHUNK_BLOCKS_HPP
+
+#include <engine/ecs/components/ChunkData.hpp>
+#include <engine/ecs/components/ChunkPosition.hpp>
+
+#include <entt/entity/fwd.hpp>
+#include <glm/vec3.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace engine::world {
+
+    using ChunkBlocks = std::span<engine::Block const, engine::components::ChunkData::block_count>;
+
+    // blocks are centred on integer world coordinates, like their models, so block x spans x - 0.5 to x + 0.5
+    // adding this gives the coordinates where it spans x to x + 1
+    inline constexpr float grid_offset = 0.5f;
+
+    inline constexpr std::int32_t chunk_size = engine::components::ChunkData::chunk_size;
+    static_assert(std::has_single_bit(engine::components::ChunkData::chunk_size), "world to chunk coordinates use shifts and masks");
+    inline constexpr int chunk_shift = std::countr_zero(engine::components::ChunkData::chunk_size);
+
+    // index in ChunkData::blocks of a block local to its chunk
+    [[nodiscard]]
+    constexpr std::size_t block_index(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+    {
+        return (static_cast<std::size_t>(x) * chunk_size + y) * chunk_size + z;
+    }
+
+    [[nodiscard]]
+    constexpr engine::components::ChunkPosition chunk_of(glm::ivec3 block, std::int32_t dimension) noexcept
+    {
+        return { block.x >> chunk_shift, block.y >> chunk_shift, block.z >> chunk_shift, dimension };
+    }
+
+    [[nodiscard]]
+    constexpr glm::u32vec3 local_of(glm::ivec3 block) noexcept
+    {
+        return glm::u32vec3 { block & (chunk_size - 1) };
+    }
+
+    /**
+     * blocks of a chunk, either owned or still mapped from its region file
+     */
+    [[nodiscard]]
+    ChunkBlocks chunk_blocks(entt::registry const &, entt::entity chunk);
+
+    // blocks of a chunk that have a payload, either owned or decoded next to the mapped blocks
+    [[nodiscard]]
+    engine::BlockPayloads const &chunk_payloads(entt::registry const &, entt::entity chunk);
+
+    /**
+     * blocks of a chunk that is about to change, tags it as modified so it gets saved
+     * copies a mapped chunk into an owned ChunkData the first time it is called on it
+     */
+    [[nodiscard]]
+    engine::components::ChunkData &writable_chunk(entt::registry &, entt::entity chunk);
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
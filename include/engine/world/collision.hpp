@@ -0,0 +1,56 @@
+#ifndef ENGINE_WORLD_COLLISION_HPP
+#define ENGINE_WORLD_COLLISION_HPP
+
+#include <engine/BlockType.hpp>
+#include <engine/assets/BlockMesh.hpp>
+#include <engine/named_storage.hpp>
+
+#include <entt/entity/storage.hpp>
+#include <glm/vec3.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace engine::world {
+
+    class Dimension;
+
+    // in the coordinates where block (x, y, z) spans (x, y, z) to (x + 1, y + 1, z + 1)
+    struct Box {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    /**
+     * collision box of every block type, the bounds of its solid faces
+     * built once so colliding doesn't look up the block type and its mesh for every block
+     */
+    class CollisionShapes {
+    public:
+        CollisionShapes() = default;
+        CollisionShapes(engine::named_storage<engine::BlockType> const &, entt::storage<engine::assets::BlockMesh> const &);
+
+        // nullptr for blocks bodies go through
+        [[nodiscard]]
+        Box const *shape(entt::id_type type_id) const noexcept
+        {
+            if (type_id >= m_shapes.size() || !m_shapes[type_id]) return nullptr;
+            return &*m_shapes[type_id];
+        }
+
+    private:
+        // indexed by type id
+        std::vector<std::optional<Box>> m_shapes;
+    };
+
+    /**
+     * moves every engine::components::Body of the dimension by its velocity
+     * each axis is resolved on its own, so bodies slide along what they hit, and low ledges are stepped up
+     * the blocks around a body are found through the chunks' Occupancy, empty bricks are skipped whole
+     * and the boxes of the others are gathered once per call, bodies close to each other share them
+     */
+    void move_bodies(Dimension &, CollisionShapes const &, float delta);
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
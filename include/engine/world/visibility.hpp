@@ -0,0 +1,45 @@
+#ifndef ENGINE_WORLD_VISIBILITY_HPP
+#define ENGINE_WORLD_VISIBILITY_HPP
+
+#include <engine/BlockType.hpp>
+#include <engine/Sides.hpp>
+#include <engine/named_storage.hpp>
+#include <engine/world/chunk_blocks.hpp>
+
+#include <bit>
+#include <cstdint>
+
+namespace engine::world {
+
+    /**
+     * which faces of a chunk can see each other through it
+     * looking into a chunk through one face, only the chunks past the faces connected to it can be seen
+     */
+    struct FaceConnectivity {
+        // faces connected to each face, indexed by the bit of the face in engine::Sides
+        engine::Sides connected[6] {};
+
+        // a chunk without any opaque block
+        [[nodiscard]]
+        static constexpr FaceConnectivity open() noexcept
+        {
+            FaceConnectivity result;
+            for (auto &faces : result.connected)
+                faces = engine::Sides::ALL;
+            return result;
+        }
+
+        [[nodiscard]]
+        constexpr bool connects(engine::Sides from, engine::Sides to) const noexcept
+        {
+            return connected[std::countr_zero(static_cast<std::uint8_t>(from))] & to;
+        }
+    };
+
+    // flood fills the blocks that aren't opaque, faces touched by the same region are connected
+    [[nodiscard]]
+    FaceConnectivity face_connectivity(ChunkBlocks, engine::named_storage<engine::BlockType> const &);
+
+} // namespace engine::world
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef MATH_FRUSTUM_HPP
+#define MATH_FRUSTUM_HPP
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace math {
+
+    // the six planes of a view volume, a point p is inside when dot(xyz, p) + w >= 0 for all of them
+    struct Frustum {
+        // left, right, bottom, top, near, far
+        glm::vec4 planes[6];
+
+        // from a projection * view matrix, the planes end up in the space the view matrix transforms from
+        [[nodiscard]]
+        static Frustum from_matrix(glm::mat4 const &projection_view) noexcept;
+
+        // conservative, boxes near a corner of the frustum may pass without touching it
+        [[nodiscard]]
+        bool intersects(glm::vec3 center, glm::vec3 half_extents) const noexcept;
+    };
+
+    /**
+     * tests many boxes of the same size against a frustum, 4 or 8 at a time depending on the cpu
+     * the centers are split per axis so they can be loaded straight into vector registers
+     * visible[i] is set to 1 if box i may intersect the frustum and 0 if it's surely outside
+     */
+    void cull_boxes(Frustum const &, glm::vec3 half_extents, std::span<float const> x, std::span<float const> y, std::span<float const> z, std::span<std::uint8_t> visible);
+
+} // namespace math
+
+#endif
\ No newline at end of file
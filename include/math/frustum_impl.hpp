@@ -0,0 +1,27 @@
+#ifndef MATH_FRUSTUM_IMPL_HPP
+#define MATH_FRUSTUM_IMPL_HPP
+
+// Kernels of math::cull_boxes, one per instruction set.
+//
+// They don't see glm, the planes are handed over with the extents of the boxes already folded into w,
+// so a box is outside as soon as its center is behind one of them. See noise_impl.hpp for what this
+// header may include.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace math::frustum_impl {
+
+    using cull_function = void (*)(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible);
+
+    void cull_scalar(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible);
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_FRUSTUM_X86_KERNELS
+    void cull_sse2(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible);
+    void cull_avx(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible);
+#endif
+
+} // namespace math::frustum_impl
+
+#endif
\ No newline at end of file
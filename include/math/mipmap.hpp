@@ -0,0 +1,34 @@
+#ifndef MATH_MIPMAP_HPP
+#define MATH_MIPMAP_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace math {
+
+    // size of the next mip level, odd sizes round down
+    [[nodiscard]]
+    constexpr std::uint32_t mip_size(std::uint32_t size) noexcept
+    {
+        return size > 1 ? size / 2 : 1;
+    }
+
+    // levels down to 1x1, the full size one included
+    [[nodiscard]]
+    constexpr std::uint32_t mip_levels(std::uint32_t width, std::uint32_t height) noexcept
+    {
+        return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    /**
+     * box filters 8 bit rgba pixels into the next mip level, each pixel the average of a 2x2 block, 4 at a time on x86
+     * odd sizes drop their last row or column and sizes of 1 repeat theirs
+     * dst holds mip_size(width) * mip_size(height) pixels
+     */
+    void downsample_rgba8(std::span<std::uint8_t const> src, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> dst);
+
+} // namespace math
+
+#endif
\ No newline at end of file
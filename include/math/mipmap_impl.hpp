@@ -0,0 +1,24 @@
+#ifndef MATH_MIPMAP_IMPL_HPP
+#define MATH_MIPMAP_IMPL_HPP
+
+// Kernels of math::downsample_rgba8, one per instruction set.
+//
+// They filter a single row of the next level from the two rows above it, so the odd sizes are handled
+// once by the caller. See noise_impl.hpp for what this header may include.
+
+#include <cstdint>
+
+namespace math::mipmap_impl {
+
+    using downsample_function = void (*)(std::uint8_t const *row0, std::uint8_t const *row1, std::uint32_t width, std::uint8_t *dst);
+
+    void downsample_scalar(std::uint8_t const *row0, std::uint8_t const *row1, std::uint32_t width, std::uint8_t *dst);
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_MIPMAP_X86_KERNELS
+    void downsample_sse2(std::uint8_t const *row0, std::uint8_t const *row1, std::uint32_t width, std::uint8_t *dst);
+#endif
+
+} // namespace math::mipmap_impl
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef MATH_NOISE_HPP
+#define MATH_NOISE_HPP
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace math::noise {
+
+    // coherent noise for world generation
+    //
+    // there is no per-sample entry point on purpose, the only way to evaluate noise is to fill a
+    // whole chunk-sized grid at once so the kernels can work on several lanes per instruction
+
+    enum class Type : std::uint8_t {
+        value,
+        perlin,
+        simplex,
+        cellular, // distance to the closest feature point (F1), remapped to [-1, 1]
+    };
+
+    struct Settings {
+        Type type = Type::perlin;
+        std::int32_t seed = 0;
+        float frequency = 1.0f / 64.0f;
+
+        // fractal brownian motion, a single octave is plain noise
+        std::uint32_t octaves = 1;
+        float lacunarity = 2.0f;
+        float gain = 0.5f;
+    };
+
+    inline constexpr std::size_t grid_size = 16;
+
+    // indexed as [x * grid_size + z]
+    using Grid2D = std::span<float, grid_size * grid_size>;
+    // indexed as [x * grid_size * grid_size + y * grid_size + z], same as engine::components::ChunkData
+    using Grid3D = std::span<float, grid_size * grid_size * grid_size>;
+
+    enum class Kernel : std::uint8_t {
+        scalar,
+        sse2,
+        avx2,
+    };
+
+    /**
+     * the kernel used by the overloads that don't take one,
+     * the fastest one supported by the running cpu
+     */
+    [[nodiscard]]
+    Kernel kernel() noexcept;
+
+    [[nodiscard]]
+    bool is_supported(Kernel) noexcept;
+
+    /**
+     * fills the grid with the noise sampled at integer coordinates (origin.x + x, origin.y + z)
+     * values are roughly in the [-1, 1] range
+     */
+    void fill_2d(Settings const &, glm::ivec2 origin, Grid2D out);
+    void fill_2d(Kernel, Settings const &, glm::ivec2 origin, Grid2D out);
+
+    /**
+     * fills the grid with the noise sampled at integer coordinates origin + (x, y, z)
+     * values are roughly in the [-1, 1] range
+     */
+    void fill_3d(Settings const &, glm::ivec3 origin, Grid3D out);
+    void fill_3d(Kernel, Settings const &, glm::ivec3 origin, Grid3D out);
+
+} // namespace math::noise
+
+#endif
@@ -0,0 +1,409 @@
+#ifndef MATH_NOISE_IMPL_HPP
+#define MATH_NOISE_IMPL_HPP
+
+// Kernels shared by every instruction set the noise is compiled for.
+//
+// Each translation unit in src/math/noise*.cpp defines a lane type `V` inside an anonymous namespace
+// and instantiates the templates below with it, so the generated code for every instruction set stays
+// local to its translation unit.
+//
+// This header, like every other *_impl.hpp of math, is included after the `#pragma GCC target` of the
+// translation unit, so whatever it includes is compiled for that instruction set too. It may only pull
+// headers without inline functions, like <cstddef> and <cstdint>, or ones the translation unit already
+// included before the pragma, like <math/noise.hpp> here. Otherwise an inline function could be emitted
+// with instructions the running cpu doesn't support and picked by the linker for every caller.
+
+#include <math/noise.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace math::noise::impl {
+
+    using fill_2d_function = void (*)(Settings const &, std::int32_t x, std::int32_t z, float *out);
+    using fill_3d_function = void (*)(Settings const &, std::int32_t x, std::int32_t y, std::int32_t z, float *out);
+
+    void fill_2d_scalar(Settings const &, std::int32_t x, std::int32_t z, float *out);
+    void fill_3d_scalar(Settings const &, std::int32_t x, std::int32_t y, std::int32_t z, float *out);
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_NOISE_X86_KERNELS
+    void fill_2d_sse2(Settings const &, std::int32_t x, std::int32_t z, float *out);
+    void fill_3d_sse2(Settings const &, std::int32_t x, std::int32_t y, std::int32_t z, float *out);
+    void fill_2d_avx2(Settings const &, std::int32_t x, std::int32_t z, float *out);
+    void fill_3d_avx2(Settings const &, std::int32_t x, std::int32_t y, std::int32_t z, float *out);
+#endif
+
+    // large primes used to decorrelate each axis before hashing
+    inline constexpr std::uint32_t prime_x = 501125321u;
+    inline constexpr std::uint32_t prime_y = 1136930381u;
+    inline constexpr std::uint32_t prime_z = 1720413743u;
+    inline constexpr std::uint32_t hash_multiplier = 0x27d4eb2du;
+
+    template <typename V>
+    inline typename V::I hash(typename V::I seed, typename V::I x, typename V::I y)
+    {
+        auto h = V::ixor(seed, V::ixor(x, y));
+        h = V::imul(h, V::iset(hash_multiplier));
+        return V::ixor(h, V::template srl<15>(h));
+    }
+
+    template <typename V>
+    inline typename V::I hash(typename V::I seed, typename V::I x, typename V::I y, typename V::I z)
+    {
+        auto h = V::ixor(seed, V::ixor(x, V::ixor(y, z)));
+        h = V::imul(h, V::iset(hash_multiplier));
+        return V::ixor(h, V::template srl<15>(h));
+    }
+
+    // maps the low 24 bits of the hash to [-1, 1]
+    template <typename V>
+    inline typename V::F hash_to_float(typename V::I h)
+    {
+        auto const bits = V::to_float(V::iand(h, V::iset(0xFFFFFFu)));
+        return V::sub(V::mul(bits, V::fset(2.0f / 16777215.0f)), V::fset(1.0f));
+    }
+
+    // 6t^5 - 15t^4 + 10t^3
+    template <typename V>
+    inline typename V::F fade(typename V::F t)
+    {
+        auto const t3 = V::mul(V::mul(t, t), t);
+        return V::mul(t3, V::add(V::mul(t, V::sub(V::mul(t, V::fset(6.0f)), V::fset(15.0f))), V::fset(10.0f)));
+    }
+
+    template <typename V>
+    inline typename V::F lerp(typename V::F a, typename V::F b, typename V::F t)
+    {
+        return V::add(a, V::mul(t, V::sub(b, a)));
+    }
+
+    // gradients (±1, ±0.5) and (±0.5, ±1)
+    template <typename V>
+    inline typename V::F gradient(typename V::I h, typename V::F x, typename V::F y)
+    {
+        auto const swap = V::ieq(V::iand(h, V::iset(4u)), V::iset(4u));
+        auto const u = V::select(swap, y, x);
+        auto const v = V::mul(V::select(swap, x, y), V::fset(0.5f));
+        auto const negate_u = V::ieq(V::iand(h, V::iset(1u)), V::iset(1u));
+        auto const negate_v = V::ieq(V::iand(h, V::iset(2u)), V::iset(2u));
+        return V::add(V::negate_if(negate_u, u), V::negate_if(negate_v, v));
+    }
+
+    // the 12 edges of a cube plus 4 repeated ones, as in Ken Perlin's improved noise
+    template <typename V>
+    inline typename V::F gradient(typename V::I h, typename V::F x, typename V::F y, typename V::F z)
+    {
+        h = V::iand(h, V::iset(15u));
+        auto const u = V::select(V::ilt(h, V::iset(8u)), x, y);
+        auto const h12_or_14 = V::mor(V::ieq(h, V::iset(12u)), V::ieq(h, V::iset(14u)));
+        auto const v = V::select(V::ilt(h, V::iset(4u)), y, V::select(h12_or_14, x, z));
+        auto const negate_u = V::ieq(V::iand(h, V::iset(1u)), V::iset(1u));
+        auto const negate_v = V::ieq(V::iand(h, V::iset(2u)), V::iset(2u));
+        return V::add(V::negate_if(negate_u, u), V::negate_if(negate_v, v));
+    }
+
+    template <typename V>
+    struct Value {
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y);
+            auto const sx = fade<V>(V::sub(x, x0)), sy = fade<V>(V::sub(y, y0));
+
+            auto const px0 = V::imul(V::to_int(x0), V::iset(prime_x)), px1 = V::iadd(px0, V::iset(prime_x));
+            auto const py0 = V::imul(V::to_int(y0), V::iset(prime_y)), py1 = V::iadd(py0, V::iset(prime_y));
+
+            auto const v0 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py0)), hash_to_float<V>(hash<V>(seed, px1, py0)), sx);
+            auto const v1 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py1)), hash_to_float<V>(hash<V>(seed, px1, py1)), sx);
+            return lerp<V>(v0, v1, sy);
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y, typename V::F z)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y), z0 = V::floor(z);
+            auto const sx = fade<V>(V::sub(x, x0)), sy = fade<V>(V::sub(y, y0)), sz = fade<V>(V::sub(z, z0));
+
+            auto const px0 = V::imul(V::to_int(x0), V::iset(prime_x)), px1 = V::iadd(px0, V::iset(prime_x));
+            auto const py0 = V::imul(V::to_int(y0), V::iset(prime_y)), py1 = V::iadd(py0, V::iset(prime_y));
+            auto const pz0 = V::imul(V::to_int(z0), V::iset(prime_z)), pz1 = V::iadd(pz0, V::iset(prime_z));
+
+            auto const v00 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py0, pz0)), hash_to_float<V>(hash<V>(seed, px1, py0, pz0)), sx);
+            auto const v10 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py1, pz0)), hash_to_float<V>(hash<V>(seed, px1, py1, pz0)), sx);
+            auto const v01 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py0, pz1)), hash_to_float<V>(hash<V>(seed, px1, py0, pz1)), sx);
+            auto const v11 = lerp<V>(hash_to_float<V>(hash<V>(seed, px0, py1, pz1)), hash_to_float<V>(hash<V>(seed, px1, py1, pz1)), sx);
+            return lerp<V>(lerp<V>(v00, v10, sy), lerp<V>(v01, v11, sy), sz);
+        }
+    };
+
+    template <typename V>
+    struct Perlin {
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y);
+            auto const fx0 = V::sub(x, x0), fy0 = V::sub(y, y0);
+            auto const fx1 = V::sub(fx0, V::fset(1.0f)), fy1 = V::sub(fy0, V::fset(1.0f));
+            auto const sx = fade<V>(fx0), sy = fade<V>(fy0);
+
+            auto const px0 = V::imul(V::to_int(x0), V::iset(prime_x)), px1 = V::iadd(px0, V::iset(prime_x));
+            auto const py0 = V::imul(V::to_int(y0), V::iset(prime_y)), py1 = V::iadd(py0, V::iset(prime_y));
+
+            auto const v0 = lerp<V>(gradient<V>(hash<V>(seed, px0, py0), fx0, fy0), gradient<V>(hash<V>(seed, px1, py0), fx1, fy0), sx);
+            auto const v1 = lerp<V>(gradient<V>(hash<V>(seed, px0, py1), fx0, fy1), gradient<V>(hash<V>(seed, px1, py1), fx1, fy1), sx);
+            return V::mul(lerp<V>(v0, v1, sy), V::fset(1.3f));
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y, typename V::F z)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y), z0 = V::floor(z);
+            auto const fx0 = V::sub(x, x0), fy0 = V::sub(y, y0), fz0 = V::sub(z, z0);
+            auto const fx1 = V::sub(fx0, V::fset(1.0f)), fy1 = V::sub(fy0, V::fset(1.0f)), fz1 = V::sub(fz0, V::fset(1.0f));
+            auto const sx = fade<V>(fx0), sy = fade<V>(fy0), sz = fade<V>(fz0);
+
+            auto const px0 = V::imul(V::to_int(x0), V::iset(prime_x)), px1 = V::iadd(px0, V::iset(prime_x));
+            auto const py0 = V::imul(V::to_int(y0), V::iset(prime_y)), py1 = V::iadd(py0, V::iset(prime_y));
+            auto const pz0 = V::imul(V::to_int(z0), V::iset(prime_z)), pz1 = V::iadd(pz0, V::iset(prime_z));
+
+            auto const v00 = lerp<V>(gradient<V>(hash<V>(seed, px0, py0, pz0), fx0, fy0, fz0), gradient<V>(hash<V>(seed, px1, py0, pz0), fx1, fy0, fz0), sx);
+            auto const v10 = lerp<V>(gradient<V>(hash<V>(seed, px0, py1, pz0), fx0, fy1, fz0), gradient<V>(hash<V>(seed, px1, py1, pz0), fx1, fy1, fz0), sx);
+            auto const v01 = lerp<V>(gradient<V>(hash<V>(seed, px0, py0, pz1), fx0, fy0, fz1), gradient<V>(hash<V>(seed, px1, py0, pz1), fx1, fy0, fz1), sx);
+            auto const v11 = lerp<V>(gradient<V>(hash<V>(seed, px0, py1, pz1), fx0, fy1, fz1), gradient<V>(hash<V>(seed, px1, py1, pz1), fx1, fy1, fz1), sx);
+            return lerp<V>(lerp<V>(v00, v10, sy), lerp<V>(v01, v11, sy), sz);
+        }
+    };
+
+    template <typename V>
+    struct Simplex {
+        static typename V::F corner(typename V::I h, typename V::F x, typename V::F y)
+        {
+            auto t = V::sub(V::sub(V::fset(0.5f), V::mul(x, x)), V::mul(y, y));
+            t = V::max(t, V::fset(0.0f));
+            t = V::mul(t, t);
+            return V::mul(V::mul(t, t), gradient<V>(h, x, y));
+        }
+
+        static typename V::F corner(typename V::I h, typename V::F x, typename V::F y, typename V::F z)
+        {
+            auto t = V::sub(V::sub(V::sub(V::fset(0.6f), V::mul(x, x)), V::mul(y, y)), V::mul(z, z));
+            t = V::max(t, V::fset(0.0f));
+            t = V::mul(t, t);
+            return V::mul(V::mul(t, t), gradient<V>(h, x, y, z));
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y)
+        {
+            constexpr float F2 = 0.366025403784f; // (sqrt(3) - 1) / 2
+            constexpr float G2 = 0.211324865405f; // (3 - sqrt(3)) / 6
+
+            auto const s = V::mul(V::add(x, y), V::fset(F2));
+            auto const i = V::floor(V::add(x, s)), j = V::floor(V::add(y, s));
+            auto const t = V::mul(V::add(i, j), V::fset(G2));
+            auto const x0 = V::sub(x, V::sub(i, t)), y0 = V::sub(y, V::sub(j, t));
+
+            // lower or upper triangle of the skewed cell
+            auto const upper = V::gt(x0, y0);
+            auto const i1 = V::select(upper, V::fset(1.0f), V::fset(0.0f));
+            auto const j1 = V::select(upper, V::fset(0.0f), V::fset(1.0f));
+
+            auto const x1 = V::add(V::sub(x0, i1), V::fset(G2)), y1 = V::add(V::sub(y0, j1), V::fset(G2));
+            auto const x2 = V::add(V::sub(x0, V::fset(1.0f)), V::fset(2.0f * G2)), y2 = V::add(V::sub(y0, V::fset(1.0f)), V::fset(2.0f * G2));
+
+            auto const pi0 = V::imul(V::to_int(i), V::iset(prime_x)), pi2 = V::iadd(pi0, V::iset(prime_x));
+            auto const pj0 = V::imul(V::to_int(j), V::iset(prime_y)), pj2 = V::iadd(pj0, V::iset(prime_y));
+            auto const pi1 = V::iselect(upper, pi2, pi0), pj1 = V::iselect(upper, pj0, pj2);
+
+            auto const n0 = corner(hash<V>(seed, pi0, pj0), x0, y0);
+            auto const n1 = corner(hash<V>(seed, pi1, pj1), x1, y1);
+            auto const n2 = corner(hash<V>(seed, pi2, pj2), x2, y2);
+            return V::mul(V::add(V::add(n0, n1), n2), V::fset(90.0f));
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y, typename V::F z)
+        {
+            constexpr float F3 = 1.0f / 3.0f;
+            constexpr float G3 = 1.0f / 6.0f;
+
+            auto const s = V::mul(V::add(V::add(x, y), z), V::fset(F3));
+            auto const i = V::floor(V::add(x, s)), j = V::floor(V::add(y, s)), k = V::floor(V::add(z, s));
+            auto const t = V::mul(V::add(V::add(i, j), k), V::fset(G3));
+            auto const x0 = V::sub(x, V::sub(i, t)), y0 = V::sub(y, V::sub(j, t)), z0 = V::sub(z, V::sub(k, t));
+
+            // rank the coordinates to find which of the six tetrahedra contains the point
+            auto const x_ge_y = V::ge(x0, y0), y_ge_z = V::ge(y0, z0), x_ge_z = V::ge(x0, z0);
+            auto const i1 = V::mand(x_ge_y, x_ge_z);
+            auto const j1 = V::mand(V::mnot(x_ge_y), y_ge_z);
+            auto const k1 = V::mand(V::mnot(x_ge_z), V::mnot(y_ge_z));
+            auto const i2 = V::mor(x_ge_y, x_ge_z);
+            auto const j2 = V::mor(V::mnot(x_ge_y), y_ge_z);
+            auto const k2 = V::mnot(V::mand(x_ge_z, y_ge_z));
+
+            auto const one = V::fset(1.0f), zero = V::fset(0.0f);
+            auto const x1 = V::add(V::sub(x0, V::select(i1, one, zero)), V::fset(G3));
+            auto const y1 = V::add(V::sub(y0, V::select(j1, one, zero)), V::fset(G3));
+            auto const z1 = V::add(V::sub(z0, V::select(k1, one, zero)), V::fset(G3));
+            auto const x2 = V::add(V::sub(x0, V::select(i2, one, zero)), V::fset(2.0f * G3));
+            auto const y2 = V::add(V::sub(y0, V::select(j2, one, zero)), V::fset(2.0f * G3));
+            auto const z2 = V::add(V::sub(z0, V::select(k2, one, zero)), V::fset(2.0f * G3));
+            auto const x3 = V::add(V::sub(x0, one), V::fset(3.0f * G3));
+            auto const y3 = V::add(V::sub(y0, one), V::fset(3.0f * G3));
+            auto const z3 = V::add(V::sub(z0, one), V::fset(3.0f * G3));
+
+            auto const pi0 = V::imul(V::to_int(i), V::iset(prime_x)), pi3 = V::iadd(pi0, V::iset(prime_x));
+            auto const pj0 = V::imul(V::to_int(j), V::iset(prime_y)), pj3 = V::iadd(pj0, V::iset(prime_y));
+            auto const pk0 = V::imul(V::to_int(k), V::iset(prime_z)), pk3 = V::iadd(pk0, V::iset(prime_z));
+
+            auto const n0 = corner(hash<V>(seed, pi0, pj0, pk0), x0, y0, z0);
+            auto const n1 = corner(hash<V>(seed, V::iselect(i1, pi3, pi0), V::iselect(j1, pj3, pj0), V::iselect(k1, pk3, pk0)), x1, y1, z1);
+            auto const n2 = corner(hash<V>(seed, V::iselect(i2, pi3, pi0), V::iselect(j2, pj3, pj0), V::iselect(k2, pk3, pk0)), x2, y2, z2);
+            auto const n3 = corner(hash<V>(seed, pi3, pj3, pk3), x3, y3, z3);
+            return V::mul(V::add(V::add(n0, n1), V::add(n2, n3)), V::fset(32.0f));
+        }
+    };
+
+    template <typename V>
+    struct Cellular {
+        static typename V::F remap(typename V::F distance_squared)
+        {
+            auto const distance = V::min(V::sqrt(distance_squared), V::fset(1.0f));
+            return V::sub(V::mul(distance, V::fset(2.0f)), V::fset(1.0f));
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y);
+            auto const fx = V::sub(x, x0), fy = V::sub(y, y0);
+            auto const px = V::imul(V::to_int(x0), V::iset(prime_x));
+            auto const py = V::imul(V::to_int(y0), V::iset(prime_y));
+
+            auto closest = V::fset(2.0f);
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    auto const h = hash<V>(seed,
+                        V::iadd(px, V::iset(static_cast<std::uint32_t>(dx) * prime_x)),
+                        V::iadd(py, V::iset(static_cast<std::uint32_t>(dy) * prime_y)));
+
+                    // feature point position inside the cell, 16 bits per axis
+                    auto const jx = V::mul(V::to_float(V::iand(h, V::iset(0xFFFFu))), V::fset(1.0f / 65536.0f));
+                    auto const jy = V::mul(V::to_float(V::template srl<16>(h)), V::fset(1.0f / 65536.0f));
+
+                    auto const vx = V::sub(V::add(V::fset(static_cast<float>(dx)), jx), fx);
+                    auto const vy = V::sub(V::add(V::fset(static_cast<float>(dy)), jy), fy);
+                    closest = V::min(closest, V::add(V::mul(vx, vx), V::mul(vy, vy)));
+                }
+            }
+            return remap(closest);
+        }
+
+        static typename V::F sample(typename V::I seed, typename V::F x, typename V::F y, typename V::F z)
+        {
+            auto const x0 = V::floor(x), y0 = V::floor(y), z0 = V::floor(z);
+            auto const fx = V::sub(x, x0), fy = V::sub(y, y0), fz = V::sub(z, z0);
+            auto const px = V::imul(V::to_int(x0), V::iset(prime_x));
+            auto const py = V::imul(V::to_int(y0), V::iset(prime_y));
+            auto const pz = V::imul(V::to_int(z0), V::iset(prime_z));
+
+            auto closest = V::fset(3.0f);
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        auto const h = hash<V>(seed,
+                            V::iadd(px, V::iset(static_cast<std::uint32_t>(dx) * prime_x)),
+                            V::iadd(py, V::iset(static_cast<std::uint32_t>(dy) * prime_y)),
+                            V::iadd(pz, V::iset(static_cast<std::uint32_t>(dz) * prime_z)));
+
+                        // feature point position inside the cell, 10 bits per axis
+                        auto const jx = V::mul(V::to_float(V::iand(h, V::iset(0x3FFu))), V::fset(1.0f / 1024.0f));
+                        auto const jy = V::mul(V::to_float(V::iand(V::template srl<10>(h), V::iset(0x3FFu))), V::fset(1.0f / 1024.0f));
+                        auto const jz = V::mul(V::to_float(V::iand(V::template srl<20>(h), V::iset(0x3FFu))), V::fset(1.0f / 1024.0f));
+
+                        auto const vx = V::sub(V::add(V::fset(static_cast<float>(dx)), jx), fx);
+                        auto const vy = V::sub(V::add(V::fset(static_cast<float>(dy)), jy), fy);
+                        auto const vz = V::sub(V::add(V::fset(static_cast<float>(dz)), jz), fz);
+                        closest = V::min(closest, V::add(V::add(V::mul(vx, vx), V::mul(vy, vy)), V::mul(vz, vz)));
+                    }
+                }
+            }
+            return remap(closest);
+        }
+    };
+
+    // sum of octaves, normalized so the result stays in the range of a single octave
+    template <typename V, typename Noise, typename... Coords>
+    inline typename V::F fractal(Settings const &settings, Coords... coords)
+    {
+        auto result = V::fset(0.0f);
+        float amplitude = 1.0f;
+        float total_amplitude = 0.0f;
+        float frequency = settings.frequency;
+        auto const octaves = settings.octaves ? settings.octaves : 1;
+
+        for (std::uint32_t octave = 0; octave < octaves; ++octave) {
+            auto const seed = V::iset(static_cast<std::uint32_t>(settings.seed) + octave);
+            auto const f = V::fset(frequency);
+            result = V::add(result, V::mul(V::fset(amplitude), Noise::sample(seed, V::mul(coords, f)...)));
+
+            total_amplitude += amplitude;
+            amplitude *= settings.gain;
+            frequency *= settings.lacunarity;
+        }
+
+        return V::mul(result, V::fset(1.0f / total_amplitude));
+    }
+
+    template <typename V, typename Noise>
+    inline void fill_2d(Settings const &settings, std::int32_t x, std::int32_t z, float *out)
+    {
+        static_assert(grid_size % V::width == 0);
+
+        auto const lanes = V::to_float(V::iadd(V::iset(static_cast<std::uint32_t>(z)), V::iota()));
+        for (std::size_t i = 0; i < grid_size; ++i) {
+            auto const px = V::fset(static_cast<float>(x + static_cast<std::int32_t>(i)));
+            for (std::size_t k = 0; k < grid_size; k += V::width) {
+                auto const pz = V::add(lanes, V::fset(static_cast<float>(k)));
+                V::store(out + i * grid_size + k, fractal<V, Noise>(settings, px, pz));
+            }
+        }
+    }
+
+    template <typename V, typename Noise>
+    inline void fill_3d(Settings const &settings, std::int32_t x, std::int32_t y, std::int32_t z, float *out)
+    {
+        static_assert(grid_size % V::width == 0);
+
+        auto const lanes = V::to_float(V::iadd(V::iset(static_cast<std::uint32_t>(z)), V::iota()));
+        for (std::size_t i = 0; i < grid_size; ++i) {
+            auto const px = V::fset(static_cast<float>(x + static_cast<std::int32_t>(i)));
+            for (std::size_t j = 0; j < grid_size; ++j) {
+                auto const py = V::fset(static_cast<float>(y + static_cast<std::int32_t>(j)));
+                for (std::size_t k = 0; k < grid_size; k += V::width) {
+                    auto const pz = V::add(lanes, V::fset(static_cast<float>(k)));
+                    V::store(out + (i * grid_size + j) * grid_size + k, fractal<V, Noise>(settings, px, py, pz));
+                }
+            }
+        }
+    }
+
+    template <typename V>
+    inline void fill_2d(Settings const &settings, std::int32_t x, std::int32_t z, float *out)
+    {
+        switch (settings.type) {
+        case Type::value: return fill_2d<V, Value<V>>(settings, x, z, out);
+        case Type::perlin: return fill_2d<V, Perlin<V>>(settings, x, z, out);
+        case Type::simplex: return fill_2d<V, Simplex<V>>(settings, x, z, out);
+        case Type::cellular: return fill_2d<V, Cellular<V>>(settings, x, z, out);
+        }
+    }
+
+    template <typename V>
+    inline void fill_3d(Settings const &settings, std::int32_t x, std::int32_t y, std::int32_t z, float *out)
+    {
+        switch (settings.type) {
+        case Type::value: return fill_3d<V, Value<V>>(settings, x, y, z, out);
+        case Type::perlin: return fill_3d<V, Perlin<V>>(settings, x, y, z, out);
+        case Type::simplex: return fill_3d<V, Simplex<V>>(settings, x, y, z, out);
+        case Type::cellular: return fill_3d<V, Cellular<V>>(settings, x, y, z, out);
+        }
+    }
+
+} // namespace math::noise::impl
+
+#endif
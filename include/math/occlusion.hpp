@@ -0,0 +1,55 @@
+#ifndef MATH_OCCLUSION_HPP
+#define MATH_OCCLUSION_HPP
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace math {
+
+    /**
+     * coarse depth buffer rasterized on the cpu for occlusion culling
+     * boxes known to be completely opaque are drawn into it, then other boxes are tested against
+     * a hierarchy of the farthest depths in it, so a test costs a handful of reads at any size
+     * depths are window depths, 0 at the near plane and 1 at the far one
+     */
+    class OcclusionBuffer {
+    public:
+        static constexpr int width = 256;
+        static constexpr int height = 128;
+
+        OcclusionBuffer();
+
+        // starts over, everything is at the far plane
+        void clear(glm::mat4 const &projection_view);
+
+        // only the pixels the box covers completely get its farthest depth in them
+        // boxes crossing the near plane are skipped, it's always safe to draw fewer occluders
+        void add_occluder(glm::vec3 min, glm::vec3 max);
+
+        // after the last occluder and before the first test
+        void build_hierarchy();
+
+        // conservative, boxes crossing the near plane are never occluded
+        [[nodiscard]]
+        bool is_occluded(glm::vec3 min, glm::vec3 max) const noexcept;
+
+        // row major, bottom row first
+        [[nodiscard]]
+        std::span<float const> depth() const noexcept { return m_levels.front(); }
+
+    private:
+        // window coordinates of the corners, false if any is in front of the near plane
+        bool project(glm::vec3 min, glm::vec3 max, glm::vec3 (&corners)[8]) const noexcept;
+
+        glm::mat4 m_projection_view;
+        // level 0 is the depth buffer, each next one keeps the farthest depth of 2x2 texels of the previous one
+        std::vector<std::vector<float>> m_levels;
+    };
+
+} // namespace math
+
+#endif
\ No newline at end of file
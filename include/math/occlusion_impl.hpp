@@ -0,0 +1,97 @@
+#ifndef MATH_OCCLUSION_IMPL_HPP
+#define MATH_OCCLUSION_IMPL_HPP
+
+// Rasterizers of math::OcclusionBuffer, one per instruction set.
+//
+// An occluder comes as the outline of a box in window coordinates, x and y in pixels, and the depth
+// planes of its faces facing the camera. Rasterization is conservative: a pixel is only covered when
+// the whole of it is inside the outline, and keeps the farthest depth the box has anywhere in it.
+// See noise_impl.hpp for what this header may include.
+
+#include <cstddef>
+
+namespace math::occlusion_impl {
+
+    struct Occluder {
+        // the convex hull of the projected corners, counter clockwise
+        float x[8], y[8];
+        int vertex_count;
+        // z = plane[0] + plane[1] * x + plane[2] * y, a box faces the camera with three faces at most
+        float planes[3][3];
+        int plane_count;
+    };
+
+    using raster_function = void (*)(float *depth, int width, int height, Occluder const &);
+
+    void raster_scalar(float *depth, int width, int height, Occluder const &);
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_OCCLUSION_X86_KERNELS
+    // width must be a multiple of 4
+    void raster_sse2(float *depth, int width, int height, Occluder const &);
+#endif
+
+    // what every kernel needs to know about an occluder before walking its pixels, all of it at pixel centers
+    struct Setup {
+        // the pixel is inside edge i when ex[i] * (x - ox[i]) + ey[i] * (y - oy[i]) >= margin[i]
+        float ex[8], ey[8], ox[8], oy[8], margin[8];
+        int edge_count;
+        // the farthest depth of plane i in the pixel is pz[i] + pdx[i] * x + pdy[i] * y
+        float pz[3], pdx[3], pdy[3];
+        int plane_count;
+        int min_x, max_x, min_y, max_y;
+    };
+
+    // false if no pixel is completely inside the occluder
+    inline bool setup(Occluder const &occluder, int width, int height, Setup &result) noexcept
+    {
+        if (occluder.vertex_count < 3 || occluder.plane_count == 0) return false;
+
+        auto const abs = [](float v) { return v < 0.0f ? -v : v; };
+        auto const floor = [](float v) { return static_cast<int>(v) - (static_cast<float>(static_cast<int>(v)) > v); };
+        auto const ceil = [&](float v) { return -floor(-v); };
+
+        float lo_x = occluder.x[0], hi_x = occluder.x[0], lo_y = occluder.y[0], hi_y = occluder.y[0];
+        for (int i = 1; i < occluder.vertex_count; ++i) {
+            lo_x = occluder.x[i] < lo_x ? occluder.x[i] : lo_x;
+            hi_x = occluder.x[i] > hi_x ? occluder.x[i] : hi_x;
+            lo_y = occluder.y[i] < lo_y ? occluder.y[i] : lo_y;
+            hi_y = occluder.y[i] > hi_y ? occluder.y[i] : hi_y;
+        }
+        if (hi_x < 1.0f || hi_y < 1.0f || lo_x > static_cast<float>(width - 1) || lo_y > static_cast<float>(height - 1)) return false;
+
+        // pixel i spans [i, i + 1], only the ones within the bounds can be completely inside
+        result.min_x = lo_x < 0.0f ? 0 : ceil(lo_x);
+        result.max_x = hi_x > static_cast<float>(width) ? width - 1 : floor(hi_x) - 1;
+        result.min_y = lo_y < 0.0f ? 0 : ceil(lo_y);
+        result.max_y = hi_y > static_cast<float>(height) ? height - 1 : floor(hi_y) - 1;
+        if (result.min_x > result.max_x || result.min_y > result.max_y) return false;
+
+        // a corner of the pixel is half a pixel away from its center on both axes, so an edge function
+        // is at most half the sum of its gradients lower than at the center anywhere in the pixel
+        result.edge_count = occluder.vertex_count;
+        for (int i = 0; i < occluder.vertex_count; ++i) {
+            int const next = i + 1 == occluder.vertex_count ? 0 : i + 1;
+            float const dx = occluder.x[next] - occluder.x[i];
+            float const dy = occluder.y[next] - occluder.y[i];
+            result.ex[i] = -dy;
+            result.ey[i] = dx;
+            result.ox[i] = occluder.x[i];
+            result.oy[i] = occluder.y[i];
+            result.margin[i] = 0.5f * (abs(dx) + abs(dy));
+        }
+
+        // and a plane is at most that much farther
+        result.plane_count = occluder.plane_count;
+        for (int i = 0; i < occluder.plane_count; ++i) {
+            auto const &plane = occluder.planes[i];
+            result.pz[i] = plane[0] + 0.5f * (abs(plane[1]) + abs(plane[2]));
+            result.pdx[i] = plane[1];
+            result.pdy[i] = plane[2];
+        }
+        return true;
+    }
+
+} // namespace math::occlusion_impl
+
+#endif
\ No newline at end of file
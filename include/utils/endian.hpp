@@ -0,0 +1,48 @@
+#ifndef UTILS_ENDIAN_HPP
+#define UTILS_ENDIAN_HPP
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+
+namespace utils {
+
+    // on-disk formats are always little endian
+
+    template <std::integral T>
+    [[nodiscard]]
+    constexpr T to_little_endian(T value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::big)
+            return std::byteswap(value);
+        else
+            return value;
+    }
+
+    template <std::integral T>
+    [[nodiscard]]
+    constexpr T from_little_endian(T value) noexcept
+    {
+        return to_little_endian(value);
+    }
+
+    template <std::integral T>
+    void store_le(std::byte *dst, T value) noexcept
+    {
+        value = to_little_endian(value);
+        std::memcpy(dst, &value, sizeof(value));
+    }
+
+    template <std::integral T>
+    [[nodiscard]]
+    T load_le(std::byte const *src) noexcept
+    {
+        T value;
+        std::memcpy(&value, src, sizeof(value));
+        return from_little_endian(value);
+    }
+
+} // namespace utils
+
+#endif
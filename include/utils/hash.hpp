@@ -0,0 +1,27 @@
+#ifndef UTILS_HASH_HPP
+#define UTILS_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace utils {
+
+    constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325u;
+
+    /**
+     * 64 bit FNV-1a, pass the previous result as seed to hash in pieces
+     * good for checksums and content keys, not for anything adversarial
+     */
+    [[nodiscard]]
+    constexpr std::uint64_t fnv1a(std::span<std::byte const> bytes, std::uint64_t seed = fnv1a_offset_basis) noexcept
+    {
+        constexpr std::uint64_t prime = 0x100000001b3u;
+        for (auto const byte : bytes)
+            seed = (seed ^ static_cast<std::uint8_t>(byte)) * prime;
+        return seed;
+    }
+
+} // namespace utils
+
+#endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <type_traits>
 #include <variant>
 
 namespace utils {
@@ -26,22 +27,24 @@ namespace utils {
         std::shared_future<void> m_sfut = m_start_pro.get_future();
 
         std::uint32_t m_to_process;
-        std::vector<std::thread> m_threads;
         Status m_status;
 
         std::queue<std::pair<std::promise<Ret>, std::tuple<Args...>>> m_queue;
-        std::mutex m_mutex;
+        mutable std::mutex m_mutex;
         std::condition_variable m_cv;
 
         std::condition_variable m_start_cv;
         std::uint32_t m_started;
 
+        // last, the threads use everything above as soon as they start
+        std::vector<std::thread> m_threads;
+
     public:
         thread_pool(Ret (*func)(Args...), std::uint32_t max_threads)
             : m_to_process { 0 }
-            , m_threads { init_vec(max_threads, &thread_pool::thread_func, this, func, m_sfut) }
             , m_status { STARTING }
             , m_started { 0 }
+            , m_threads { init_vec(max_threads, &thread_pool::thread_func, this, func, m_sfut) }
         {
             {
                 std::unique_lock lock { m_mutex };
@@ -142,7 +145,12 @@ namespace utils {
                         return args;
                     }());
                     try {
-                        promise.set_value(std::apply(func, args));
+                        if constexpr (std::is_void_v<Ret>) {
+                            std::apply(func, std::move(args));
+                            promise.set_value();
+                        } else {
+                            promise.set_value(std::apply(func, std::move(args)));
+                        }
                     } catch (...) {
                         promise.set_exception(std::current_exception());
                     }
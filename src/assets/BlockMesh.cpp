@@ -204,6 +204,20 @@ void engine::assets::BlockMesh::load_json(std::filesystem::path const &path)
     }
 
     SPDLOG_INFO("Compiling block model from file {}", path);
+    // the sides solid faces close
+    engine::Sides closed = engine::Sides::NONE;
+    bool solid = false, translucent = false;
+    for (auto const &face : faces) {
+        if (face.solid) {
+            closed = static_cast<engine::Sides>(closed | face.sides);
+            solid = true;
+        } else {
+            translucent = true;
+        }
+    }
+    m_opaque = closed == engine::Sides::ALL && !translucent;
+    m_solid = solid;
+
     m_textures.insert(m_textures.end(), textures.cbegin(), textures.cend());
     std::for_each(faces.begin(), faces.end(), [&](ModelFace &face) {
         face.texture = static_cast<std::uint32_t>(textures.index_of(textures.find(face.texture)));
@@ -28,6 +28,21 @@ engine::assets::Image::Image(std::string_view name)
 {
 }
 
+void engine::assets::Image::create(std::uint32_t width, std::uint32_t height)
+{
+    m_surface = std::unique_ptr<SDL_Surface, Deleter>(SDL_CreateRGBSurfaceWithFormat(0, static_cast<int>(width), static_cast<int>(height), 32, SDL_PIXELFORMAT_RGBA32));
+    if (!m_surface)
+        throw engine::sdl::Error::current();
+}
+
+void engine::assets::Image::convert(std::uint32_t pixel_format)
+{
+    if (m_surface->format->format == pixel_format) return;
+    m_surface = std::unique_ptr<SDL_Surface, Deleter>(SDL_ConvertSurfaceFormat(m_surface.get(), pixel_format, 0));
+    if (!m_surface)
+        throw engine::sdl::Error::current();
+}
+
 void engine::assets::Image::load(std::span<std::byte const> bytes, std::optional<std::string_view> format)
 {
     SPDLOG_INFO("loading image from memory");
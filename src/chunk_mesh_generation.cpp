@@ -3,6 +3,7 @@
 #include <engine/Sides.hpp>
 #include <engine/ecs/components/ChunkData.hpp>
 #include <engine/rendering/Mesh.hpp>
+#include <engine/world/chunk_blocks.hpp>
 #include <math/bits.hpp>
 #include <math/constexpr.hpp>
 
@@ -22,7 +23,7 @@ constexpr static std::size_t cube_at(First first, Rest... rest)
         return first * math::c_ipow_v<D, sizeof...(Rest)> + cube_at<D>(rest...);
 }
 
-static engine::Sides get_visible_sides(engine::Game const &game, engine::components::ChunkData const &chunk, glm::u32vec3 block_pos)
+static engine::Sides get_visible_sides(engine::Game const &game, engine::world::ChunkBlocks blocks, glm::u32vec3 block_pos)
 {
     using engine::Sides;
     constexpr auto chunk_size = engine::components::ChunkData::chunk_size;
@@ -42,12 +43,12 @@ static engine::Sides get_visible_sides(engine::Game const &game, engine::compone
     };
 
     auto const [x, y, z] = block_pos;
-    bool const is_top_visible = y == chunk_size - 1 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x, y + 1, z)], Sides::BOTTOM));
-    bool const is_bottom_visible = y == 0 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x, y - 1, z)], Sides::TOP));
-    bool const is_east_visible = x == chunk_size - 1 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x + 1, y, z)], Sides::WEST));
-    bool const is_west_visible = x == 0 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x - 1, y, z)], Sides::EAST));
-    bool const is_north_visible = z == 0 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x, y, z - 1)], Sides::SOUTH));
-    bool const is_south_visible = z == chunk_size - 1 || !(is_solid(chunk.blocks[cube_at<chunk_size>(x, y, z + 1)], Sides::NORTH));
+    bool const is_top_visible = y == chunk_size - 1 || !(is_solid(blocks[cube_at<chunk_size>(x, y + 1, z)], Sides::BOTTOM));
+    bool const is_bottom_visible = y == 0 || !(is_solid(blocks[cube_at<chunk_size>(x, y - 1, z)], Sides::TOP));
+    bool const is_east_visible = x == chunk_size - 1 || !(is_solid(blocks[cube_at<chunk_size>(x + 1, y, z)], Sides::WEST));
+    bool const is_west_visible = x == 0 || !(is_solid(blocks[cube_at<chunk_size>(x - 1, y, z)], Sides::EAST));
+    bool const is_north_visible = z == 0 || !(is_solid(blocks[cube_at<chunk_size>(x, y, z - 1)], Sides::SOUTH));
+    bool const is_south_visible = z == chunk_size - 1 || !(is_solid(blocks[cube_at<chunk_size>(x, y, z + 1)], Sides::NORTH));
 
     // clang-format off
     // pack to a Sides flags
@@ -133,9 +134,11 @@ static void remove_unreferenced_vertices(engine::rendering::Mesh &mesh_data)
             mesh_data.vertices.erase(mesh_data.vertices.begin() + i);
 }
 
-engine::rendering::Mesh engine::Game::generate_solid_mesh(engine::components::ChunkPosition const &chunk_position, engine::components::ChunkData const &chunk_data)
+engine::rendering::Mesh engine::Game::generate_solid_mesh(engine::world::ChunkBlocks blocks, engine::BlockPayloads const &payloads)
 {
     engine::rendering::Mesh result;
+    // its payload is the packed color its color masks are tinted with
+    auto const colorful_id = block_registry().index("colorful_block");
 
     // avoid small allocations
     result.vertices.reserve(256);
@@ -147,9 +150,9 @@ engine::rendering::Mesh engine::Game::generate_solid_mesh(engine::components::Ch
         std::uint_fast8_t const y = i >> 4 & 0xF;
         std::uint_fast8_t const z = i >> 0 & 0xF;
 
-        engine::Block const &block = chunk_data.blocks[i];
+        engine::Block const &block = blocks[i];
 
-        Sides sides = get_visible_sides(*this, chunk_data, { x, y, z });
+        Sides sides = get_visible_sides(*this, blocks, { x, y, z });
         if (!sides) continue;
 
         auto const maybe_mesh = [&]() -> engine::rendering::Mesh const * {
@@ -169,6 +172,14 @@ engine::rendering::Mesh engine::Game::generate_solid_mesh(engine::components::Ch
         for (auto &vertex : mesh.vertices) // transform to chunk coords
             vertex.position += glm::vec3 { x, y, z };
 
+        if (colorful_id != entt::null && block.type_id == static_cast<entt::id_type>(colorful_id)) {
+            if (auto const payload = payloads.get(i); payload != entt::null) {
+                auto const color = math::unpack_u32(payload);
+                for (auto &vertex : mesh.vertices)
+                    vertex.color = glm::u8vec3 { color.x, color.y, color.z };
+            }
+        }
+
         for (auto &index : mesh.indices)
             index += result.vertices.size();
 
@@ -197,9 +208,6 @@ engine::rendering::Mesh engine::Game::generate_solid_mesh(engine::components::Ch
     }
 #endif
 
-    for (auto &vertex : result.vertices) // transform to world coords
-        vertex.position += glm::vec3 { chunk_position.x, chunk_position.y, chunk_position.z } * static_cast<float>(chunk_size);
-
     return result;
 }
 
@@ -208,13 +216,16 @@ engine::rendering::Mesh engine::Game::generate_translucent_mesh(engine::componen
 {
     engine::rendering::Mesh result;
 
-    auto const it = m_chunks.find(chunk_position);
-    if (it == m_chunks.end())
+    auto const *const dimension = find_dimension(chunk_position.dimension);
+    if (!dimension)
+        return result;
+
+    entt::entity const chunk = dimension->chunk(chunk_position);
+    if (chunk == entt::null)
         return result;
 
-    entt::entity const chunk = it->second;
-    auto const &chunk_data = m_entity_registry.get<engine::components::ChunkData>(chunk);
-    (void)chunk_data;
+    auto const blocks = engine::world::chunk_blocks(dimension->registry(), chunk);
+    (void)blocks;
 
     // avoid small allocations
     result.vertices.reserve(256);
@@ -0,0 +1,14 @@
+#include <engine/BlockType.hpp>
+#include <engine/assets/BlockMesh.hpp>
+
+engine::BlockType engine::BlockType::from_mesh(entt::id_type mesh_id, engine::assets::BlockMesh const &mesh)
+{
+    return BlockType {
+        .mesh_id = mesh_id,
+        .texture_ids = {},
+        .masks_ids = {},
+        // only a block closed on every side hides what's behind it
+        .opaque = mesh.opaque(),
+        .motion_blocking = mesh.solid(),
+    };
+}
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <rapidjson/reader.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
 #include <cstring>
@@ -85,14 +86,47 @@ engine::Config const &engine::Config::load(std::filesystem::path const &path)
         return std::nullopt;
     };
 
+    auto get_boolean = [&doc](char const *json_pointer) -> std::optional<bool> {
+        if (auto *pointer = rapidjson::Pointer(json_pointer).Get(doc); pointer && pointer->IsBool()) {
+            return pointer->GetBool();
+        } else if (pointer) {
+            utils::show_error("Error loading engine config file."sv, fmt::format("{} must be a boolean", json_pointer));
+        }
+        return std::nullopt;
+    };
+
     s_config.sdl.video_driver = get_string("/SDL/video_driver");
     s_config.sdl.audio_driver = get_string("/SDL/audio_driver");
     s_config.imgui.font_path = get_string("/ImGui/font_path");
 
+    if (auto maybe_uncompressed = get_boolean("/world/uncompressed"))
+        s_config.world.uncompressed = *maybe_uncompressed;
+    if (auto maybe_interval = get_integer("/world/autosave_interval"))
+        s_config.world.autosave_interval = static_cast<unsigned>(std::max(*maybe_interval, 1));
+
+    if (auto maybe_budget = get_integer("/rendering/upload_budget"))
+        s_config.rendering.upload_budget = static_cast<unsigned>(std::max(*maybe_budget, 0));
+    if (auto maybe_budget = get_integer("/rendering/upload_time_budget"))
+        s_config.rendering.upload_time_budget = static_cast<unsigned>(std::max(*maybe_budget, 0));
+    if (auto maybe_distance = get_integer("/rendering/far_distance"))
+        s_config.rendering.far_distance = static_cast<unsigned>(std::max(*maybe_distance, 0));
+    if (auto maybe_headless = get_boolean("/rendering/headless/enabled"))
+        s_config.rendering.headless.enabled = *maybe_headless;
+    if (auto maybe_width = get_integer("/rendering/headless/width"))
+        s_config.rendering.headless.width = static_cast<unsigned>(std::max(*maybe_width, 1));
+    if (auto maybe_height = get_integer("/rendering/headless/height"))
+        s_config.rendering.headless.height = static_cast<unsigned>(std::max(*maybe_height, 1));
+    if (auto maybe_interval = get_integer("/rendering/headless/dump_interval"))
+        s_config.rendering.headless.dump_interval = static_cast<unsigned>(std::max(*maybe_interval, 0));
+    if (auto maybe_frames = get_integer("/rendering/headless/frames"))
+        s_config.rendering.headless.frames = static_cast<unsigned>(std::max(*maybe_frames, 0));
+
     if (auto maybe_root = get_string("/folders/root"))
         s_config.folders.root = std::move(*maybe_root);
     if (auto maybe_cache = get_string("/folders/cache"))
         s_config.folders.cache = std::move(*maybe_cache);
+    if (auto maybe_saves = get_string("/folders/saves"))
+        s_config.folders.saves = std::move(*maybe_saves);
 
     s_config.opengl.red_bits = get_integer("/SDL/OpenGL/red_bits");
     s_config.opengl.green_bits = get_integer("/SDL/OpenGL/green_bits");
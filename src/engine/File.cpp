@@ -40,18 +40,18 @@ static T read_to(std::FILE *fp)
 
         errno = 0;
         std::size_t const bytes_read = std::fread(result.data() + result.size() - buffer_size, 1, buffer_size, fp);
+        // what wasn't read is dropped, at the end of the file too, where it's the whole buffer
+        result.resize(result.size() - buffer_size + bytes_read);
         if (bytes_read == 0) {
             if (std::ferror(fp))
                 throw std::system_error(errno, std::generic_category(), "std::fread() failed");
-            else
-                break;
+            break;
         }
-        result.resize(result.size() - buffer_size + bytes_read);
     }
     return result;
 }
 
-static boost::interprocess::mapped_region map_to_memory(std::FILE *fp)
+boost::interprocess::mapped_region engine::map_to_memory(std::FILE *fp)
 {
     struct HandleWrapper {
         std::FILE *fp;
@@ -81,7 +81,7 @@ std::span<std::byte const> engine::impl::FileBytesBase::span()
     return std::visit(overloaded(
                           [&](std::monostate) mutable {
                               try {
-                                  auto &region = m_cache.emplace<boost::interprocess::mapped_region>(map_to_memory(m_fp));
+                                  auto &region = m_cache.emplace<boost::interprocess::mapped_region>(engine::map_to_memory(m_fp));
                                   return std::span<std::byte const>(reinterpret_cast<std::byte const *>(region.get_address()), region.get_size());
                               } catch (std::system_error const &ex) {
                                   SPDLOG_WARN("failed to memory map file: {}", ex.what());
@@ -0,0 +1,89 @@
+#include <engine/binary_archive.hpp>
+#include <engine/errors/CorruptedData.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace {
+    constexpr std::byte magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'B' }, std::byte { 'A' } };
+    // written in the native byte order, reads back swapped on the other one
+    constexpr std::uint16_t byte_order_mark = 0xFEFF;
+}
+
+engine::BinaryOutputArchive::BinaryOutputArchive(std::vector<std::byte> &buffer)
+    : m_buffer(&buffer)
+{
+    write_bytes(magic);
+    write(byte_order_mark);
+    write(version);
+}
+
+engine::BinaryInputArchive::BinaryInputArchive(std::span<std::byte const> bytes)
+    : m_bytes(bytes)
+{
+    std::byte file_magic[sizeof(magic)];
+    std::uint16_t file_byte_order_mark;
+    std::uint16_t file_version;
+
+    if (m_bytes.size() < sizeof(magic) + sizeof(file_byte_order_mark) + sizeof(file_version)) {
+        SPDLOG_ERROR("binary archive is truncated ({} bytes)", m_bytes.size());
+        throw engine::errors::CorruptedData();
+    }
+
+    read_bytes(std::as_writable_bytes(std::span(file_magic)));
+    read(file_byte_order_mark);
+    read(file_version);
+
+    if (std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+        SPDLOG_ERROR("not a binary archive");
+        throw engine::errors::CorruptedData();
+    }
+
+    if (file_byte_order_mark == std::byteswap(byte_order_mark)) {
+        m_swapped = true;
+        file_version = std::byteswap(file_version);
+    } else if (file_byte_order_mark != byte_order_mark) {
+        SPDLOG_ERROR("binary archive has an invalid byte order mark {:#06x}", file_byte_order_mark);
+        throw engine::errors::CorruptedData();
+    }
+
+    if (file_version != BinaryOutputArchive::version) {
+        SPDLOG_ERROR("binary archive version {} is not supported", file_version);
+        throw engine::errors::CorruptedData();
+    }
+}
+
+void engine::BinaryInputArchive::read_bytes(std::span<std::byte> bytes)
+{
+    if (bytes.size() > m_bytes.size()) {
+        SPDLOG_ERROR("binary archive is truncated, {} bytes left but {} requested", m_bytes.size(), bytes.size());
+        throw engine::errors::CorruptedData();
+    }
+    // empty vectors read into a null pointer, which memcpy doesn't allow
+    std::ranges::copy(m_bytes.first(bytes.size()), bytes.begin());
+    m_bytes = m_bytes.subspan(bytes.size());
+}
+
+std::span<std::byte const> engine::BinaryInputArchive::view_bytes(std::size_t size)
+{
+    if (size > m_bytes.size()) {
+        SPDLOG_ERROR("binary archive is truncated, {} bytes left but {} requested", m_bytes.size(), size);
+        throw engine::errors::CorruptedData();
+    }
+    auto const result = m_bytes.first(size);
+    m_bytes = m_bytes.subspan(size);
+    return result;
+}
+
+void engine::BinaryInputArchive::throw_not_swappable()
+{
+    SPDLOG_ERROR("binary archive was written with the other byte order and contains a type that can't be swapped");
+    throw engine::errors::CorruptedData();
+}
+
+void engine::BinaryInputArchive::throw_truncated() const
+{
+    SPDLOG_ERROR("binary archive is truncated, {} bytes left", m_bytes.size());
+    throw engine::errors::CorruptedData();
+}
\ No newline at end of file
@@ -12,4 +12,11 @@ std::span<const engine::ecs::System> const engine::ecs::systems = std::span<engi
 
 std::span<engine::ecs::SystemDependencies const> const engine::ecs::systems_dependencies = std::span<engine::ecs::SystemDependencies const>(
     &__start_system_dependencies_array[0],
-    &__stop_system_dependencies_array[0]);
\ No newline at end of file
+    &__stop_system_dependencies_array[0]);
+
+void engine::ecs::run_systems(entt::registry &registry, std::chrono::duration<double> delta)
+{
+    registry.ctx().insert_or_assign(Delta { delta });
+    for (auto const &system : systems)
+        system.pfn_execute(registry);
+}
\ No newline at end of file
@@ -1,41 +1,45 @@
 #include <engine/ecs/system.hpp>
 
+#include <engine/ecs/components/Body.hpp>
 #include <engine/ecs/components/Camera.hpp>
 #include <engine/ecs/components/LocalPlayer.hpp>
-#include <engine/rendering/IRenderer.hpp>
 
 #include <SDL_keyboard.h>
 #include <entt/entt.hpp>
 
 constexpr float camera_speed = 25.0f;
-#include <chrono>
-
-struct Delta {
-    std::chrono::duration<double> delta;
-};
+// the camera's x goes the other way than the world's, see actual_position in the renderer
+constexpr glm::vec3 mirror_x { -1.0f, 1.0f, 1.0f };
 
 void localplayer_camera(entt::registry &registry)
 {
     auto const keyboard_state = SDL_GetKeyboardState(nullptr);
-    auto &renderer = registry.ctx().get<std::unique_ptr<engine::rendering::IRenderer>>();
-    auto const delta = static_cast<float>(registry.ctx().get<Delta>().delta.count());
-    (void)renderer;
+    auto const delta = static_cast<float>(registry.ctx().get<engine::ecs::Delta>().delta.count());
 
     auto view = registry.view<engine::components::LocalPlayer, engine::components::Camera>();
-    view.each([&](engine::components::Camera &camera) {
+    view.each([&](entt::entity entity, engine::components::Camera &camera) {
         const glm::vec3 right = -glm::cross(camera.up, camera.forward);
+        glm::vec3 movement {};
         if (keyboard_state[SDL_SCANCODE_W])
-            camera.position += glm::normalize(glm::vec3 { -camera.forward.x, 0.0f, camera.forward.z }) * camera_speed * delta;
+            movement += glm::normalize(glm::vec3 { -camera.forward.x, 0.0f, camera.forward.z });
         if (keyboard_state[SDL_SCANCODE_S])
-            camera.position -= glm::normalize(glm::vec3 { -camera.forward.x, 0.0f, camera.forward.z }) * camera_speed * delta;
+            movement -= glm::normalize(glm::vec3 { -camera.forward.x, 0.0f, camera.forward.z });
         if (keyboard_state[SDL_SCANCODE_D])
-            camera.position += glm::vec3 { -right.x, 0.0f, right.z } * camera_speed * delta;
+            movement += glm::vec3 { -right.x, 0.0f, right.z };
         if (keyboard_state[SDL_SCANCODE_A])
-            camera.position -= glm::vec3 { -right.x, 0.0f, right.z } * camera_speed * delta;
+            movement -= glm::vec3 { -right.x, 0.0f, right.z };
         if (keyboard_state[SDL_SCANCODE_SPACE])
-            camera.position.y += camera_speed * delta;
+            movement.y += 1.0f;
         if (keyboard_state[SDL_SCANCODE_LSHIFT])
-            camera.position.y -= camera_speed * delta;
+            movement.y -= 1.0f;
+
+        // with a body the movement goes through the collisions, see engine::world::move_bodies
+        if (auto *body = registry.try_get<engine::components::Body>(entity)) {
+            body->velocity = movement * camera_speed * mirror_x;
+            camera.position = (body->position + glm::vec3 { 0.0f, engine::components::LocalPlayer::eye_height, 0.0f }) * mirror_x;
+        } else {
+            camera.position += movement * camera_speed * delta;
+        }
     });
 }
 
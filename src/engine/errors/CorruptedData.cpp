@@ -0,0 +1,11 @@
+#include <engine/errors/CorruptedData.hpp>
+
+engine::errors::CorruptedData::CorruptedData() noexcept
+    : std::exception()
+{
+}
+
+char const *engine::errors::CorruptedData::what() const noexcept
+{
+    return "engine::errors::CorruptedData";
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <engine/rendering/RangeAllocator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+engine::rendering::RangeAllocator::RangeAllocator(std::size_t capacity)
+{
+    reset(capacity);
+}
+
+std::size_t engine::rendering::RangeAllocator::allocate(std::size_t size)
+{
+    if (size == 0) return 0;
+
+    auto const it = std::ranges::find_if(m_free, [size](auto const &range) { return range.second >= size; });
+    if (it == m_free.end()) return npos;
+
+    auto const [offset, free_size] = *it;
+    m_free.erase(it);
+    if (free_size > size)
+        m_free.emplace(offset + size, free_size - size);
+    m_used += size;
+    return offset;
+}
+
+void engine::rendering::RangeAllocator::free(std::size_t offset, std::size_t size)
+{
+    if (size == 0) return;
+    assert(offset + size <= m_capacity);
+
+    m_used -= size;
+    auto next = m_free.lower_bound(offset);
+    if (next != m_free.begin()) {
+        if (auto const prev = std::prev(next); prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            m_free.erase(prev);
+        }
+    }
+    if (next != m_free.end() && offset + size == next->first) {
+        size += next->second;
+        next = m_free.erase(next);
+    }
+    m_free.emplace_hint(next, offset, size);
+}
+
+void engine::rendering::RangeAllocator::grow(std::size_t capacity)
+{
+    if (capacity <= m_capacity) return;
+
+    auto const old_capacity = std::exchange(m_capacity, capacity);
+    // free() treats the new tail like any freed range, so it's merged with a free range before it
+    m_used += capacity - old_capacity;
+    free(old_capacity, capacity - old_capacity);
+}
+
+void engine::rendering::RangeAllocator::reset(std::size_t capacity)
+{
+    m_free.clear();
+    m_capacity = capacity;
+    m_used = 0;
+    if (capacity != 0)
+        m_free.emplace(0, capacity);
+}
+
+engine::rendering::RangeAllocator::Stats engine::rendering::RangeAllocator::stats() const noexcept
+{
+    Stats result {
+        .capacity = m_capacity,
+        .used = m_used,
+        .free_ranges = m_free.size(),
+        .largest_free = 0,
+    };
+    for (auto const &[offset, size] : m_free)
+        result.largest_free = std::max(result.largest_free, size);
+    return result;
+}
\ No newline at end of file
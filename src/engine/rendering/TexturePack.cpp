@@ -0,0 +1,261 @@
+#include <engine/Config.hpp>
+#include <engine/File.hpp>
+#include <engine/assets/Image.hpp>
+#include <engine/cache.hpp>
+#include <engine/rendering/TexturePack.hpp>
+#include <math/mipmap.hpp>
+#include <utils/endian.hpp>
+#include <utils/error.hpp>
+#include <utils/hash.hpp>
+#include <utils/thread_pool.hpp>
+
+#include <SDL_pixels.h>
+#include <fmt/format.h>
+#include <fmt/std.h>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/pointer.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <thread>
+
+using namespace std::literals;
+
+namespace {
+    constexpr std::byte magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'T' }, std::byte { 'P' } };
+    // bumped whenever the layout or the filtering changes
+    constexpr std::uint32_t cache_version = 1;
+    // magic, version, width, height, layers, levels, content hash
+    constexpr std::size_t header_size = 32;
+
+    // a texture followed by its mip levels
+    struct DecodedLayer {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::vector<std::byte> levels;
+    };
+}
+
+static std::size_t level_size(std::uint32_t width, std::uint32_t height, std::uint32_t layers, std::uint32_t level) noexcept
+{
+    for (std::uint32_t i = 0; i < level; ++i) {
+        width = math::mip_size(width);
+        height = math::mip_size(height);
+    }
+    return std::size_t { width } * height * layers * 4;
+}
+
+static std::size_t total_size(std::uint32_t width, std::uint32_t height, std::uint32_t layers, std::uint32_t levels) noexcept
+{
+    std::size_t result = 0;
+    for (std::uint32_t level = 0; level < levels; ++level)
+        result += level_size(width, height, layers, level);
+    return result;
+}
+
+// whatever is before the ':' names whose assets the path is in, only the game's exist for now
+static std::filesystem::path resolve(std::filesystem::path const &pack, std::string_view path)
+{
+    if (auto const colon = path.find(':'); colon != std::string_view::npos)
+        path.remove_prefix(colon + 1);
+    return pack.parent_path() / path;
+}
+
+static DecodedLayer decode_layer(std::filesystem::path path)
+{
+    engine::assets::Image image("texture"sv);
+    image.load(path);
+    image.convert(SDL_PIXELFORMAT_RGBA32);
+
+    DecodedLayer result { .width = image.width(), .height = image.height(), .levels = {} };
+    auto const levels = math::mip_levels(result.width, result.height);
+    result.levels.resize(total_size(result.width, result.height, 1, levels));
+    {
+        auto const lock = image.lock();
+        std::size_t const row_size = std::size_t { result.width } * 4;
+        for (std::uint32_t y = 0; y < result.height; ++y)
+            std::memcpy(result.levels.data() + y * row_size, lock.pixels() + y * image.pitch(), row_size);
+    }
+
+    auto *src = reinterpret_cast<std::uint8_t *>(result.levels.data());
+    auto width = result.width, height = result.height;
+    for (std::uint32_t level = 1; level < levels; ++level) {
+        auto *const dst = src + level_size(width, height, 1, 0);
+        math::downsample_rgba8({ src, level_size(width, height, 1, 0) }, width, height, { dst, level_size(width, height, 1, 1) });
+        src = dst;
+        width = math::mip_size(width);
+        height = math::mip_size(height);
+    }
+    return result;
+}
+
+engine::rendering::TexturePack engine::rendering::TexturePack::load(std::filesystem::path const &path)
+{
+    auto content = engine::File::open(path, "rb").bytes().string();
+    // before parsing in place changes it
+    auto key = utils::fnv1a(std::as_bytes(std::span(content)));
+
+    rapidjson::Document doc;
+    {
+        using namespace rapidjson;
+        doc.ParseInsitu<kParseCommentsFlag | kParseTrailingCommasFlag | kParseNanAndInfFlag>(content.data());
+    }
+    if (doc.HasParseError())
+        utils::show_error(fmt::format("Error parsing texture pack {}.", path), fmt::format("Error at offset {}: {}", doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError())));
+
+    auto const *const textures = rapidjson::Pointer("/textures").Get(doc);
+    if (!textures || !textures->IsObject())
+        utils::show_error("Error loading texture pack."sv, "/textures must be an object"sv);
+
+    TexturePack result;
+    std::vector<std::filesystem::path> files;
+    for (auto const &[name, file] : textures->GetObject()) {
+        if (!file.IsString())
+            utils::show_error("Error loading texture pack."sv, fmt::format("/textures/{} must be an string", name.GetString()));
+        result.m_names.emplace_back(name.GetString(), name.GetStringLength());
+        files.push_back(resolve(path, std::string_view { file.GetString(), file.GetStringLength() }));
+        // the files as they are, checking the cache doesn't decode anything
+        key = utils::fnv1a(engine::File::open(files.back(), "rb").bytes().span(), key);
+    }
+    if (files.empty())
+        utils::show_error("Error loading texture pack."sv, "/textures is empty"sv);
+
+    auto const cache_name = fmt::format("textures/{}.bin", path.stem().string());
+    if (result.map_cache(cache_name, key)) {
+        SPDLOG_INFO("mapped {} textures of {}x{} from the cache", result.layers(), result.width(), result.height());
+        return result;
+    }
+
+    result.build(files);
+    result.save_cache(cache_name, key);
+    SPDLOG_INFO("built {} textures of {}x{} with {} mip levels", result.layers(), result.width(), result.height(), result.levels());
+    return result;
+}
+
+bool engine::rendering::TexturePack::map_cache(std::string_view name, std::uint64_t key)
+{
+    // opening a missing cache file throws
+    try {
+        auto file = engine::get_cache_file(name);
+        if (!file) return false;
+        m_mapping = engine::map_to_memory(file.assume_value().get());
+    } catch (std::exception const &e) {
+        SPDLOG_INFO("can't use texture cache {:?}: {}", name, e.what());
+        return false;
+    }
+
+    std::span<std::byte const> const bytes(static_cast<std::byte const *>(m_mapping.get_address()), m_mapping.get_size());
+    bool valid = bytes.size() >= header_size
+        && std::memcmp(bytes.data(), magic, sizeof(magic)) == 0
+        && utils::load_le<std::uint32_t>(bytes.data() + 4) == cache_version
+        && utils::load_le<std::uint32_t>(bytes.data() + 16) == layers()
+        && utils::load_le<std::uint64_t>(bytes.data() + 24) == key;
+    if (valid) {
+        m_width = utils::load_le<std::uint32_t>(bytes.data() + 8);
+        m_height = utils::load_le<std::uint32_t>(bytes.data() + 12);
+        m_levels = utils::load_le<std::uint32_t>(bytes.data() + 20);
+        valid = m_width != 0 && m_height != 0 && m_levels == math::mip_levels(m_width, m_height)
+            && bytes.size() == header_size + total_size(m_width, m_height, layers(), m_levels);
+    }
+
+    if (!valid) {
+        SPDLOG_INFO("texture cache {:?} is out of date", name);
+        m_mapping = boost::interprocess::mapped_region {};
+        return false;
+    }
+
+    m_pixels = bytes.subspan(header_size);
+    return true;
+}
+
+void engine::rendering::TexturePack::build(std::span<std::filesystem::path const> files)
+{
+    auto const threads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, files.size());
+    utils::thread_pool pool(&decode_layer, static_cast<std::uint32_t>(threads));
+    std::vector<std::future<DecodedLayer>> futures;
+    futures.reserve(files.size());
+    for (auto const &file : files)
+        futures.push_back(pool.submit(std::filesystem::path(file)));
+    for (auto const &future : futures)
+        future.wait();
+    pool.stop();
+
+    std::vector<DecodedLayer> decoded;
+    decoded.reserve(futures.size());
+    for (auto &future : futures)
+        decoded.push_back(future.get());
+
+    m_width = decoded.front().width;
+    m_height = decoded.front().height;
+    m_levels = math::mip_levels(m_width, m_height);
+    for (std::size_t i = 0; i < decoded.size(); ++i) {
+        if (decoded[i].width != m_width || decoded[i].height != m_height)
+            utils::show_error("Error loading texture pack."sv, fmt::format("{} is {}x{} but {} is {}x{}, every texture must be the same size", files[i], decoded[i].width, decoded[i].height, files.front(), m_width, m_height));
+    }
+
+    // level after level, each with every layer
+    m_built.resize(total_size(m_width, m_height, layers(), m_levels));
+    auto *dst = m_built.data();
+    std::size_t offset = 0;
+    for (std::uint32_t level = 0; level < m_levels; ++level) {
+        auto const size = level_size(m_width, m_height, 1, level);
+        for (auto const &layer : decoded) {
+            std::memcpy(dst, layer.levels.data() + offset, size);
+            dst += size;
+        }
+        offset += size;
+    }
+    m_pixels = m_built;
+}
+
+void engine::rendering::TexturePack::save_cache(std::string_view name, std::uint64_t key) const
+{
+    // written next to it and renamed over it, so a mapped cache file never changes under anyone
+    auto const temporary = fmt::format("{}.tmp", name);
+    auto file = engine::create_cache_file(temporary);
+    if (!file) {
+        SPDLOG_WARN("failed to create texture cache {:?}", name);
+        return;
+    }
+
+    std::byte header[header_size] {};
+    std::memcpy(header, magic, sizeof(magic));
+    utils::store_le(header + 4, cache_version);
+    utils::store_le(header + 8, m_width);
+    utils::store_le(header + 12, m_height);
+    utils::store_le(header + 16, layers());
+    utils::store_le(header + 20, m_levels);
+    utils::store_le(header + 24, key);
+
+    auto *const fp = file.assume_value().get();
+    if (std::fwrite(header, 1, header_size, fp) != header_size || std::fwrite(m_pixels.data(), 1, m_pixels.size(), fp) != m_pixels.size() || std::fflush(fp) != 0) {
+        SPDLOG_WARN("failed to write texture cache {:?}", name);
+        return;
+    }
+    file.assume_value().reset();
+
+    auto const &folder = engine::config().folders.cache;
+    std::error_code ec;
+    std::filesystem::rename(folder / temporary, folder / name, ec);
+    if (ec)
+        SPDLOG_WARN("failed to replace texture cache {:?}: {}", name, ec.message());
+}
+
+std::span<std::byte const> engine::rendering::TexturePack::level(std::uint32_t level) const noexcept
+{
+    std::size_t offset = 0;
+    for (std::uint32_t i = 0; i < level; ++i)
+        offset += level_size(m_width, m_height, layers(), i);
+    return m_pixels.subspan(offset, level_size(m_width, m_height, layers(), level));
+}
+
+std::optional<std::uint32_t> engine::rendering::TexturePack::layer(std::string_view name) const noexcept
+{
+    auto const it = std::ranges::find(m_names, name);
+    if (it == m_names.end()) return std::nullopt;
+    return static_cast<std::uint32_t>(it - m_names.begin());
+}
\ No newline at end of file
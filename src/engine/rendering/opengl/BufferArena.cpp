@@ -0,0 +1,159 @@
+#include <engine/rendering/opengl/BufferArena.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+// uploads and copies go through the copy targets, binding the element array buffer would change the bound vertex array
+
+engine::rendering::opengl::BufferArena::BufferArena(StagingRing &staging, std::size_t element_size, std::size_t capacity)
+    : m_staging(&staging)
+    , m_element_size(element_size)
+    , m_ranges(capacity)
+{
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * m_element_size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+engine::rendering::opengl::BufferArena::~BufferArena()
+{
+    glDeleteBuffers(1, &m_buffer);
+}
+
+std::size_t engine::rendering::opengl::BufferArena::allocate_range(std::size_t count)
+{
+    auto offset = m_ranges.allocate(count);
+    if (offset == RangeAllocator::npos) {
+        // the new space past the end alone fits the allocation, however scattered the free space is
+        auto const old_capacity = m_ranges.capacity();
+        auto capacity = std::max<std::size_t>(old_capacity * 2, 1);
+        while (capacity - old_capacity < count)
+            capacity *= 2;
+        reallocate(capacity);
+        m_ranges.grow(capacity);
+        offset = m_ranges.allocate(count);
+    }
+    return offset;
+}
+
+auto engine::rendering::opengl::BufferArena::allocate(std::size_t count) -> Handle
+{
+    auto const offset = allocate_range(count);
+
+    Handle handle;
+    if (m_free_handles.empty()) {
+        handle = static_cast<Handle>(m_allocations.size());
+        m_allocations.emplace_back();
+    } else {
+        handle = m_free_handles.back();
+        m_free_handles.pop_back();
+    }
+    m_allocations[handle] = Allocation { .offset = offset, .count = count, .capacity = count };
+    return handle;
+}
+
+void engine::rendering::opengl::BufferArena::free(Handle handle)
+{
+    if (handle == null_handle) return;
+
+    auto &allocation = m_allocations[handle];
+    m_ranges.free(allocation.offset, allocation.capacity);
+    allocation = Allocation { .offset = 0, .count = 0, .capacity = 0 };
+    m_free_handles.push_back(handle);
+}
+
+void engine::rendering::opengl::BufferArena::resize(Handle handle, std::size_t count)
+{
+    auto &allocation = m_allocations[handle];
+    if (count > allocation.capacity) {
+        m_ranges.free(allocation.offset, allocation.capacity);
+        allocation.capacity = std::max(count, allocation.capacity + allocation.capacity / 2);
+        allocation.offset = allocate_range(allocation.capacity);
+    }
+    allocation.count = count;
+}
+
+void engine::rendering::opengl::BufferArena::trim(std::size_t count)
+{
+    count = std::min(count, m_allocations.size());
+    for (std::size_t i = 0; i < count; ++i, ++m_trim_cursor) {
+        if (m_trim_cursor >= m_allocations.size()) m_trim_cursor = 0;
+        auto &allocation = m_allocations[m_trim_cursor];
+        if (allocation.count * 2 >= allocation.capacity) continue;
+
+        m_ranges.free(allocation.offset + allocation.count, allocation.capacity - allocation.count);
+        allocation.capacity = allocation.count;
+    }
+}
+
+void engine::rendering::opengl::BufferArena::upload(Handle handle, void const *data, std::size_t count)
+{
+    if (count == 0) return;
+
+    m_staging->copy(m_buffer, m_allocations[handle].offset * m_element_size, data, count * m_element_size);
+}
+
+void engine::rendering::opengl::BufferArena::compact()
+{
+    auto const before = m_ranges.stats();
+
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, before.capacity * m_element_size, nullptr, GL_DYNAMIC_DRAW);
+
+    // in offset order, so the allocations keep their relative placement
+    std::vector<Handle> live(m_allocations.size());
+    std::iota(live.begin(), live.end(), Handle { 0 });
+    std::erase_if(live, [this](Handle handle) {
+        auto &allocation = m_allocations[handle];
+        if (allocation.count != 0) return false;
+        allocation.offset = 0;
+        allocation.capacity = 0;
+        return true;
+    });
+    std::ranges::sort(live, {}, [this](Handle handle) { return m_allocations[handle].offset; });
+
+    std::size_t offset = 0;
+    for (auto const handle : live) {
+        auto &allocation = m_allocations[handle];
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.offset * m_element_size, offset * m_element_size, allocation.count * m_element_size);
+        allocation.offset = offset;
+        allocation.capacity = allocation.count;
+        offset += allocation.count;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = buffer;
+    ++m_generation;
+
+    m_ranges.reset(before.capacity);
+    [[maybe_unused]] auto const start = m_ranges.allocate(offset);
+    assert(start == 0);
+    SPDLOG_DEBUG("compacted buffer arena, {} free ranges ({:.0f}% fragmented) into one", before.free_ranges, before.fragmentation() * 100.0f);
+}
+
+void engine::rendering::opengl::BufferArena::reallocate(std::size_t capacity)
+{
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * m_element_size, nullptr, GL_DYNAMIC_DRAW);
+    if (m_ranges.capacity() != 0)
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, m_ranges.capacity() * m_element_size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = buffer;
+    ++m_generation;
+    SPDLOG_DEBUG("buffer arena grown to {} elements", capacity);
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <engine/File.hpp>
+#include <engine/rendering/opengl/Material.hpp>
+#include <engine/rendering/opengl/UniformBlocks.hpp>
+#include <utils/error.hpp>
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/pointer.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace {
+    constexpr std::pair<char const *, GLenum> stage_types[] = {
+        { "vertex", GL_VERTEX_SHADER },
+        { "fragment", GL_FRAGMENT_SHADER },
+    };
+
+    constexpr std::size_t max_features = sizeof(engine::rendering::opengl::Material::Permutation) * 8;
+}
+
+// only the game's assets exist for now
+static std::filesystem::path resolve(std::filesystem::path const &material, std::string_view path)
+{
+    if (path.starts_with("assets://"sv))
+        return std::filesystem::path("assets") / path.substr("assets://"sv.size());
+    if (path.find("://"sv) != std::string_view::npos)
+        utils::show_error(fmt::format("Error loading material {}.", material), fmt::format("Can't resolve {:?}, only assets:// paths are supported", path));
+    return material.parent_path() / path;
+}
+
+static std::vector<std::string> read_defines(std::filesystem::path const &material, rapidjson::Value const &value, std::string_view where)
+{
+    std::vector<std::string> result;
+    if (value.IsString()) {
+        result.emplace_back(value.GetString(), value.GetStringLength());
+        return result;
+    }
+    if (!value.IsArray())
+        utils::show_error(fmt::format("Error loading material {}.", material), fmt::format("{} must be a string or an array of strings", where));
+    for (auto const &define : value.GetArray()) {
+        if (!define.IsString())
+            utils::show_error(fmt::format("Error loading material {}.", material), fmt::format("{} must be a string or an array of strings", where));
+        result.emplace_back(define.GetString(), define.GetStringLength());
+    }
+    return result;
+}
+
+engine::rendering::opengl::Material engine::rendering::opengl::Material::load(std::filesystem::path const &path)
+{
+    auto content = engine::File::open(path, "rb").bytes().string();
+
+    rapidjson::Document doc;
+    {
+        using namespace rapidjson;
+        doc.ParseInsitu<kParseCommentsFlag | kParseTrailingCommasFlag | kParseNanAndInfFlag>(content.data());
+    }
+    if (doc.HasParseError())
+        utils::show_error(fmt::format("Error parsing material {}.", path), fmt::format("Error at offset {}: {}", doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError())));
+
+    auto const error_title = fmt::format("Error loading material {}.", path);
+    if (!doc.IsObject())
+        utils::show_error(error_title, "A material must be an object"sv);
+
+    Material result;
+    result.m_path = path;
+
+    auto const *const type = rapidjson::Pointer("/type").Get(doc);
+    if (!type || !type->IsString())
+        utils::show_error(error_title, "/type must be a string"sv);
+    result.m_type.assign(type->GetString(), type->GetStringLength());
+
+    for (auto const &[name, gl_type] : stage_types) {
+        if (!doc.HasMember(name)) continue;
+        auto const &value = doc[name];
+        if (!value.IsObject() || !value.HasMember("file") || !value["file"].IsString())
+            utils::show_error(error_title, fmt::format("/{}/file must be a string", name));
+        if (value.HasMember("language") && (!value["language"].IsString() || value["language"].GetString() != "glsl"sv))
+            utils::show_error(error_title, fmt::format("/{}/language must be glsl, the only language supported by OpenGL", name));
+        result.m_stages.push_back(ShaderStage {
+            .type = gl_type,
+            .path = resolve(path, std::string_view { value["file"].GetString(), value["file"].GetStringLength() }),
+        });
+    }
+    if (result.m_stages.empty())
+        utils::show_error(error_title, "A material needs at least one shader stage"sv);
+
+    if (auto const *const defines = rapidjson::Pointer("/defines").Get(doc))
+        result.m_defines = read_defines(path, *defines, "/defines"sv);
+
+    if (auto const *const features = rapidjson::Pointer("/features").Get(doc)) {
+        if (!features->IsObject())
+            utils::show_error(error_title, "/features must be an object"sv);
+        for (auto const &[name, defines] : features->GetObject()) {
+            std::string feature(name.GetString(), name.GetStringLength());
+            auto feature_defines = read_defines(path, defines, fmt::format("/features/{}", feature));
+            result.m_features.emplace_back(std::move(feature), std::move(feature_defines));
+        }
+        if (result.m_features.size() > max_features)
+            utils::show_error(error_title, fmt::format("/features has {} features but at most {} are supported", result.m_features.size(), max_features));
+    }
+
+    SPDLOG_INFO("loaded {} material {} with {} stages and {} features", result.m_type, path, result.m_stages.size(), result.m_features.size());
+    return result;
+}
+
+engine::rendering::opengl::Material::Permutation engine::rendering::opengl::Material::feature(std::string_view name) const noexcept
+{
+    auto const it = std::ranges::find(m_features, name, [](auto const &feature) -> std::string_view { return feature.first; });
+    return it == m_features.end() ? 0 : Permutation { 1 } << (it - m_features.begin());
+}
+
+engine::rendering::opengl::Material::Program const &engine::rendering::opengl::Material::program(ProgramCache const &cache, Permutation permutation)
+{
+    if (auto const it = m_programs.find(permutation); it != m_programs.end())
+        return it->second;
+
+    auto defines = m_defines;
+    for (std::size_t i = 0; i < m_features.size(); ++i)
+        if (permutation & (Permutation { 1 } << i))
+            defines.insert(defines.end(), m_features[i].second.begin(), m_features[i].second.end());
+
+    auto const id = cache.build(m_stages, defines);
+    SPDLOG_INFO("built permutation {:#x} of material {}", permutation, m_path);
+
+    // every program of the engine samples the texture pack and the color masks from the same units
+    glUseProgram(id);
+    glUniform1i(glGetUniformLocation(id, "texture0"), 0);
+    // there are no color masks yet, nothing is bound to their unit so they read as black and the texture is used
+    glUniform1i(glGetUniformLocation(id, "texture1"), 1);
+    glUseProgram(0);
+
+    // glsl 330 can't give blocks a binding, every program gets the same ones here
+    if (auto const frame = glGetUniformBlockIndex(id, "Frame"); frame != GL_INVALID_INDEX)
+        glUniformBlockBinding(id, frame, FrameBlock::binding);
+    auto const draw = glGetUniformBlockIndex(id, "Draw");
+    if (draw != GL_INVALID_INDEX)
+        glUniformBlockBinding(id, draw, DrawBlock::binding);
+
+    return m_programs.emplace(permutation, Program { .id = id, .per_draw = draw != GL_INVALID_INDEX }).first->second;
+}
+
+void engine::rendering::opengl::Material::release() noexcept
+{
+    for (auto const &[permutation, program] : m_programs)
+        glDeleteProgram(program.id);
+    m_programs.clear();
+}
\ No newline at end of file
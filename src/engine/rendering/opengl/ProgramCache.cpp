@@ -0,0 +1,211 @@
+#include <engine/File.hpp>
+#include <engine/cache.hpp>
+#include <engine/rendering/opengl/ProgramCache.hpp>
+#include <utils/endian.hpp>
+#include <utils/error.hpp>
+#include <utils/hash.hpp>
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+    constexpr std::byte magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'P' }, std::byte { 'B' } };
+    // magic, binary format, key
+    constexpr std::size_t header_size = 16;
+}
+
+static std::uint64_t hash_string(std::string_view string, std::uint64_t seed) noexcept
+{
+    // the size too, so the pieces can't run into each other
+    auto const size = static_cast<std::uint64_t>(string.size());
+    seed = utils::fnv1a(std::as_bytes(std::span(&size, 1)), seed);
+    return utils::fnv1a(std::as_bytes(std::span(string)), seed);
+}
+
+static std::string_view gl_string(GLenum name)
+{
+    auto const *const string = reinterpret_cast<char const *>(glGetString(name));
+    return string ? std::string_view(string) : std::string_view();
+}
+
+static std::string info_log(GLuint object, bool program)
+{
+    GLint size = 0;
+    std::string result;
+    if (program) {
+        glGetProgramiv(object, GL_INFO_LOG_LENGTH, &size);
+        result.resize(static_cast<std::size_t>(size));
+        glGetProgramInfoLog(object, size, nullptr, result.data());
+    } else {
+        glGetShaderiv(object, GL_INFO_LOG_LENGTH, &size);
+        result.resize(static_cast<std::size_t>(size));
+        glGetShaderInfoLog(object, size, nullptr, result.data());
+    }
+    return result;
+}
+
+engine::rendering::opengl::ProgramCache::ProgramCache()
+    : m_driver_hash(hash_string(gl_string(GL_VERSION), hash_string(gl_string(GL_RENDERER), utils::fnv1a_offset_basis)))
+    , m_binaries(false)
+{
+#ifdef GL_ARB_get_program_binary
+    if (GLAD_GL_ARB_get_program_binary) {
+        // drivers may support the extension without any format to save to
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_binaries = formats > 0;
+    }
+#endif
+}
+
+GLuint engine::rendering::opengl::ProgramCache::build(std::span<ShaderStage const> stages, std::span<std::string const> defines) const
+{
+    // the pieces handed to glShaderSource, everything up to the end of the #version line, the defines and the rest
+    struct Source {
+        std::string text;
+        std::size_t split;
+    };
+    std::string prelude;
+    for (auto const &define : defines)
+        prelude += fmt::format("#define {}\n", define);
+
+    std::vector<Source> sources;
+    sources.reserve(stages.size());
+    auto key = m_driver_hash;
+    for (auto const &stage : stages) {
+        auto text = engine::File::open(stage.path, "r").bytes().string();
+        auto const version = text.find("#version");
+        auto const line_end = version == std::string::npos ? std::string::npos : text.find('\n', version);
+        auto const split = line_end == std::string::npos ? 0 : line_end + 1;
+
+        key = utils::fnv1a(std::as_bytes(std::span(&stage.type, 1)), key);
+        key = hash_string(text, key);
+        sources.push_back(Source { .text = std::move(text), .split = split });
+    }
+    key = hash_string(prelude, key);
+
+    if (auto const program = load(key))
+        return program;
+
+    auto const start = std::chrono::steady_clock::now();
+    GLuint const program = glCreateProgram();
+    std::vector<GLuint> shaders;
+    for (std::size_t i = 0; i < stages.size(); ++i) {
+        auto const &source = sources[i];
+        char const *const pieces[] = { source.text.data(), prelude.data(), source.text.data() + source.split };
+        GLint const lengths[] = { static_cast<GLint>(source.split), static_cast<GLint>(prelude.size()), static_cast<GLint>(source.text.size() - source.split) };
+
+        GLuint const shader = glCreateShader(stages[i].type);
+        glShaderSource(shader, 3, pieces, lengths);
+        glCompileShader(shader);
+
+        GLint success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+            utils::show_error("OpenGL Error."sv, fmt::format("Couldn't compile shader {}\n{}", stages[i].path, info_log(shader, false)));
+
+        glAttachShader(program, shader);
+        shaders.push_back(shader);
+    }
+
+#ifdef GL_ARB_get_program_binary
+    if (m_binaries)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+    glLinkProgram(program);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+        utils::show_error("OpenGL Error."sv, "Couldn't link shader\n"s + info_log(program, true));
+
+    for (auto const shader : shaders) {
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    std::chrono::duration<double, std::milli> const elapsed = std::chrono::steady_clock::now() - start;
+    SPDLOG_INFO("compiled program {:016x} in {:.1f}ms", key, elapsed.count());
+
+    save(program, key);
+    return program;
+}
+
+GLuint engine::rendering::opengl::ProgramCache::load(std::uint64_t key) const
+{
+#ifdef GL_ARB_get_program_binary
+    if (!m_binaries) return 0;
+
+    auto const name = fmt::format("shaders/{:016x}.bin", key);
+    boost::interprocess::mapped_region mapping;
+    // opening a missing cache file throws
+    try {
+        auto file = engine::get_cache_file(name);
+        if (!file) return 0;
+        mapping = engine::map_to_memory(file.assume_value().get());
+    } catch (std::exception const &) {
+        return 0;
+    }
+
+    std::span<std::byte const> const bytes(static_cast<std::byte const *>(mapping.get_address()), mapping.get_size());
+    if (bytes.size() <= header_size || std::memcmp(bytes.data(), magic, sizeof(magic)) != 0 || utils::load_le<std::uint64_t>(bytes.data() + 8) != key) {
+        SPDLOG_WARN("program cache {:?} is corrupted", name);
+        return 0;
+    }
+
+    auto const format = utils::load_le<std::uint32_t>(bytes.data() + 4);
+    auto const binary = bytes.subspan(header_size);
+    GLuint const program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        SPDLOG_INFO("program cache {:?} was rejected by the driver", name);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    SPDLOG_INFO("loaded program {:016x} from the cache", key);
+    return program;
+#else
+    (void)key;
+    return 0;
+#endif
+}
+
+void engine::rendering::opengl::ProgramCache::save(GLuint program, std::uint64_t key) const
+{
+#ifdef GL_ARB_get_program_binary
+    if (!m_binaries) return;
+
+    GLint size = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0) return;
+
+    std::vector<std::byte> data(header_size + static_cast<std::size_t>(size));
+    GLsizei length = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, size, &length, &format, data.data() + header_size);
+    std::memcpy(data.data(), magic, sizeof(magic));
+    utils::store_le(data.data() + 4, static_cast<std::uint32_t>(format));
+    utils::store_le(data.data() + 8, key);
+    data.resize(header_size + static_cast<std::size_t>(length));
+
+    auto const name = fmt::format("shaders/{:016x}.bin", key);
+    auto file = engine::create_cache_file(name);
+    if (!file || std::fwrite(data.data(), 1, data.size(), file.assume_value().get()) != data.size())
+        SPDLOG_WARN("failed to write program cache {:?}", name);
+#else
+    (void)program;
+    (void)key;
+#endif
+}
\ No newline at end of file
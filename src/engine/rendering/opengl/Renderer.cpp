@@ -2,7 +2,6 @@
 #include <engine/Camera.hpp>
 #include <engine/Config.hpp>
 #include <engine/Game.hpp>
-#include <engine/cache.hpp>
 #include <engine/rendering/opengl/Renderer.hpp>
 
 #include <SDL_mouse.h>
@@ -10,15 +9,54 @@
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
 #include <imgui.h>
+#include <math/frustum.hpp>
 #include <utils/error.hpp>
 #include <utils/file.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+
 extern engine::Camera g_camera;
 extern int g_render_distance_horizontal;
 extern int g_render_distance_vertical;
 
 using namespace std::literals;
 
+namespace {
+    // initial sizes of the arenas, they double whenever they run out
+    constexpr std::size_t initial_vertex_capacity = 1 << 18;
+    constexpr std::size_t initial_index_capacity = 1 << 20;
+    // a few frames worth of the default upload budget
+    constexpr std::size_t staging_capacity = 16u << 20;
+
+    // arenas are compacted once most of their free space is scattered in many small ranges
+    constexpr float compaction_fragmentation = 0.5f;
+    constexpr std::size_t compaction_free_ranges = 256;
+    // allocations looked at every frame for unused capacity to give back
+    constexpr std::size_t trimmed_per_frame = 64;
+
+    // the nearest occluders in view hide most of what's hidden, more would cost more than they cull
+    constexpr std::size_t max_occluders = 64;
+    // the draw blocks of a frame are written to the staging ring in slices at most this large
+    constexpr std::size_t max_draw_block_slice = staging_capacity / 4;
+}
+
+static std::size_t align_up(std::size_t size, std::size_t alignment) noexcept
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// chunk meshes are in chunk coordinates, their first block is centred here
+static glm::vec3 chunk_origin(engine::components::ChunkPosition const &position) noexcept
+{
+    constexpr auto chunk_size = static_cast<float>(engine::components::ChunkData::chunk_size);
+    return glm::vec3 { position.x, position.y, position.z } * chunk_size;
+}
+
 engine::sdl::Window engine::rendering::opengl::Renderer::create_window(const char *title, int x, int y, int w, int h, uint32_t flags)
 {
 
@@ -35,7 +73,17 @@ engine::sdl::Window engine::rendering::opengl::Renderer::create_window(const cha
     if (config.opengl.depth_bits) SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, *config.opengl.depth_bits);
     if (config.opengl.stencil_bits) SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, *config.opengl.stencil_bits);
 
+    // nothing is presented, the window only holds the context and sets the size imgui draws at
+    auto const &headless = config.rendering.headless;
+    if (headless.enabled) {
+        w = static_cast<int>(headless.width);
+        h = static_cast<int>(headless.height);
+        flags = (flags & ~SDL_WINDOW_RESIZABLE) | SDL_WINDOW_HIDDEN;
+    }
+
     auto window = engine::sdl::Window::create(title, glm::ivec2 { x, y }, glm::ivec2 { w, h }, flags | SDL_WINDOW_OPENGL);
+    if (headless.enabled)
+        return window;
 
 #ifndef NDEBUG
     if (SDL_SetRelativeMouseMode(SDL_TRUE))
@@ -80,17 +128,24 @@ void engine::rendering::opengl::Renderer::setup()
 
     glClearColor(0.0, 0.25, 0.5, 1.0);
 
-    setup_shader();
-    glGenVertexArrays(1, &m_vao);
-    glBindVertexArray(m_vao);
+    m_programs.emplace();
+    setup_materials();
     setup_texture();
 
-    glUseProgram(m_shader);
-    m_uniforms.projection = glGetUniformLocation(m_shader, "projection");
-    m_uniforms.view = glGetUniformLocation(m_shader, "view");
+    m_staging.emplace(staging_capacity);
+    GLint uniform_alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+    m_uniforms.alignment = static_cast<std::size_t>(std::max(uniform_alignment, 16));
+    m_uniforms.draw_stride = align_up(sizeof(engine::rendering::opengl::DrawBlock), m_uniforms.alignment);
+    m_uniforms.blocks_per_slice = static_cast<std::uint32_t>(max_draw_block_slice / m_uniforms.draw_stride);
+    m_uniforms.start = std::chrono::steady_clock::now();
+    m_vertex_arena.emplace(*m_staging, sizeof(rendering::Vertex), initial_vertex_capacity);
+    m_index_arena.emplace(*m_staging, sizeof(std::uint32_t), initial_index_capacity);
+    glGenVertexArrays(1, &m_vao);
+    setup_vertex_array();
 
-    glUniform1i(glGetUniformLocation(m_shader, "texture0"), 0);
-    glUseProgram(0);
+    if (engine::config().rendering.headless.enabled)
+        setup_offscreen();
 }
 
 #include <imgui_impl_opengl3.h>
@@ -110,138 +165,74 @@ void engine::rendering::opengl::Renderer::imgui_new_frame(std::shared_ptr<engine
     ImGui_ImplOpenGL3_NewFrame();
 }
 
-void engine::rendering::opengl::Renderer::setup_shader()
+void engine::rendering::opengl::Renderer::setup_materials()
 {
-#ifdef GL_ARB_get_program_binary
-    if (GLAD_GL_ARB_get_program_binary) {
-        static std::filesystem::path const ref_files[] = { "assets/terrain/basic.vert", "assets/terrain/basic.frag" };
-        auto fp = engine::get_cache_file("shaders/terrain/basic.bin"sv, ref_files);
-        if (fp) {
-            GLenum format;
-            std::fread(&format, sizeof(format), 1, fp.assume_value().get());
-            auto start = std::ftell(fp.assume_value().get());
-            std::fseek(fp.assume_value().get(), 0, SEEK_END);
-            auto stop = std::ftell(fp.assume_value().get());
-            auto len = static_cast<std::size_t>(stop - start);
-            std::fseek(fp.assume_value().get(), start, SEEK_SET);
-            auto data = std::make_unique<std::byte[]>(len);
-            std::fread(data.get(), 1, len, fp.assume_value().get());
-
-            m_shader = glCreateProgram();
-            glProgramBinary(m_shader, format, data.get(), len);
-
-            int success;
-            glGetProgramiv(m_shader, GL_LINK_STATUS, &success);
-            if (success)
-                return;
-            else
-                glDeleteProgram(m_shader);
-        }
-    }
-#endif
-
-    GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    GLuint fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-
-    auto const vertex_shader_source = engine::File::open("assets/shaders/terrain/basic.vert", "r")
-                                          .bytes()
-                                          .string();
-    auto const fragment_shader_source = engine::File::open("assets/shaders/terrain/basic.frag", "r")
-                                            .bytes()
-                                            .string();
-
-    auto const vertex_shader_source_raw = vertex_shader_source.c_str();
-    auto const fragment_shader_source_raw = fragment_shader_source.c_str();
-
-    glShaderSource(vertex_shader, 1, &vertex_shader_source_raw, nullptr);
-    glShaderSource(fragment_shader, 1, &fragment_shader_source_raw, nullptr);
-
-    glCompileShader(vertex_shader);
-    glCompileShader(fragment_shader);
-
-    int success;
-    std::string info_log;
-    GLint info_log_size;
-
-    glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderiv(vertex_shader, GL_INFO_LOG_LENGTH, &info_log_size);
-        info_log.clear();
-        info_log.resize(info_log_size);
-        glGetShaderInfoLog(vertex_shader, info_log_size, nullptr, info_log.data());
-
-        utils::show_error("OpenGL Error."sv, "Couldn't compile vertex shader\n"s + info_log);
-    }
-
-    glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderiv(fragment_shader, GL_INFO_LOG_LENGTH, &info_log_size);
-        info_log.clear();
-        info_log.resize(info_log_size);
-        glGetShaderInfoLog(fragment_shader, info_log_size, nullptr, info_log.data());
-
-        utils::show_error("OpenGL Error."sv, "Couldn't compile fragment shader\n"s + info_log);
-    }
-
-    m_shader = glCreateProgram();
+    // the permutations are built the first time something is drawn with them
+    m_terrain = engine::rendering::opengl::Material::load("assets/materials/terrain/basic.json");
+    if (m_terrain->type() != "terrain"sv)
+        utils::show_error("Error loading material assets/materials/terrain/basic.json."sv, fmt::format("It's a {} material but chunks need a terrain one", m_terrain->type()));
+    m_far_permutation = m_terrain->feature("far"sv);
+}
 
-    glAttachShader(m_shader, vertex_shader);
-    glAttachShader(m_shader, fragment_shader);
-    glLinkProgram(m_shader);
+void engine::rendering::opengl::Renderer::setup_vertex_array()
+{
+    // the element array buffer binding is part of the vertex array, the array buffer is captured by the attribute pointers
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_arena->buffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_arena->buffer());
 
-    glGetProgramiv(m_shader, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramiv(m_shader, GL_INFO_LOG_LENGTH, &info_log_size);
-        info_log.clear();
-        info_log.resize(info_log_size);
-        glGetProgramInfoLog(m_shader, info_log_size, nullptr, info_log.data());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, position));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, uv));
+    glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, color));
+    glVertexAttribPointer(3, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, light));
+    glVertexAttribIPointer(4, 2, GL_UNSIGNED_INT, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, textures));
+    for (GLuint i = 0; i < 5; ++i)
+        glEnableVertexAttribArray(i);
 
-        utils::show_error("OpenGL Error."sv, "Couldn't link shader\n"s + info_log);
-    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
-
-#ifdef GL_ARB_get_program_binary
-    if (GLAD_GL_ARB_get_program_binary) {
-        auto fp = engine::create_cache_file("shaders/terrain/basic.bin");
-        if (!fp)
-            return;
-        GLint buf_len;
-        glGetProgramiv(m_shader, GL_PROGRAM_BINARY_LENGTH, &buf_len);
-        auto data = std::make_unique<std::byte[]>(buf_len);
-        GLsizei length = buf_len;
-        GLenum format;
-        glGetProgramBinary(m_shader, buf_len, &length, &format, data.get());
-
-        std::fwrite(&format, sizeof(format), 1, fp.assume_value().get());
-        std::fwrite(data.get(), length, 1, fp.assume_value().get());
-    }
-#endif
+    m_vao_generations.vertices = m_vertex_arena->generation();
+    m_vao_generations.indices = m_index_arena->generation();
 }
 
-#include <engine/rendering/opengl/Texture.hpp>
+#include <engine/rendering/TexturePack.hpp>
 
 void engine::rendering::opengl::Renderer::setup_texture()
 {
-    auto texture = opengl::Texture();
-    texture.create();
-    texture.bind(GL_TEXTURE_2D_ARRAY)
-        .setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE)
-        .setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE)
-        .setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR)
-        .setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    auto const pack = engine::rendering::TexturePack::load("assets/texture_pack.json");
+
+    GLint max_layers;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &max_layers);
+    if (pack.layers() > static_cast<std::uint32_t>(max_layers))
+        utils::show_error("OpenGL Error."sv, fmt::format("The texture pack has {} textures but at most {} are supported.", pack.layers(), max_layers));
+
+    // the mip levels are already built, straight from the cache file when it was there
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    auto width = static_cast<GLsizei>(pack.width()), height = static_cast<GLsizei>(pack.height());
+    for (std::uint32_t level = 0; level < pack.levels(); ++level) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), GL_RGBA8, width, height, static_cast<GLsizei>(pack.layers()), 0, GL_RGBA, GL_UNSIGNED_BYTE, pack.level(level).data());
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(pack.levels() - 1));
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
 void engine::rendering::opengl::Renderer::render(float)
 {
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-    glUseProgram(m_shader);
     glActiveTexture(GL_TEXTURE0);
-#if 0
-    glBindTexture(GL_TEXTURE_2D_ARRAY, renderer.textures.texture2d_array);
-#endif
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+    // growing or compacting an arena replaces its buffer
+    if (m_vao_generations.vertices != m_vertex_arena->generation() || m_vao_generations.indices != m_index_arena->generation())
+        setup_vertex_array();
     glBindVertexArray(m_vao);
 
     int viewport[4];
@@ -251,78 +242,204 @@ void engine::rendering::opengl::Renderer::render(float)
     glm::vec3 const actual_position = glm::vec3 { -g_camera.position.x, g_camera.position.y, g_camera.position.z };
     glm::mat4 const view_matrix = glm::lookAt(actual_position, actual_position + g_camera.forward, g_camera.up);
 
-    glUniformMatrix4fv(m_uniforms.projection, 1, false, glm::value_ptr(projection_matrix));
-    glUniformMatrix4fv(m_uniforms.view, 1, false, glm::value_ptr(view_matrix));
-
-    glm::i32vec3 player_chunk = g_camera.position / static_cast<float>(engine::components::ChunkData::chunk_size);
+    constexpr auto chunk_size = static_cast<float>(engine::components::ChunkData::chunk_size);
+    // the meshes are in the space the view matrix transforms from, where the eye is actual_position
+    glm::i32vec3 const eye_chunk = glm::floor(actual_position / chunk_size);
+    engine::components::ChunkPosition const player_chunk { eye_chunk.x, eye_chunk.y, eye_chunk.z, game().current_dimension().id() };
+
+    if (m_culling.stale || m_culling.center != player_chunk || m_culling.horizontal_distance != g_render_distance_horizontal || m_culling.vertical_distance != g_render_distance_vertical)
+        sort_chunks(player_chunk);
+    m_culling.visible.resize(m_culling.meshes.size());
+    glm::mat4 const projection_view = projection_matrix * view_matrix;
+    glm::vec3 const half_extents { chunk_size / 2.0f };
+    math::cull_boxes(math::Frustum::from_matrix(projection_view), half_extents, m_culling.x, m_culling.y, m_culling.z, m_culling.visible);
+
+    // without the chunk the camera is in there's nowhere to start looking from
+    if (auto const start = m_culling.indices.find(player_chunk); start != m_culling.indices.end())
+        cull_unreachable(start->second);
+
+    // the chunks are sorted nearest first, so are the occluders
+    m_occlusion.clear(projection_view);
+    for (std::size_t i = 0, occluders = 0; i < m_culling.meshes.size() && occluders < max_occluders; ++i) {
+        if (!m_culling.visible[i] || !m_culling.meshes[i]->occluder) continue;
+        glm::vec3 const center { m_culling.x[i], m_culling.y[i], m_culling.z[i] };
+        m_occlusion.add_occluder(center - half_extents, center + half_extents);
+        ++occluders;
+    }
+    m_occlusion.build_hierarchy();
+    for (std::size_t i = 0; i < m_culling.meshes.size(); ++i) {
+        if (!m_culling.visible[i]) continue;
+        glm::vec3 const center { m_culling.x[i], m_culling.y[i], m_culling.z[i] };
+        m_culling.visible[i] = !m_occlusion.is_occluded(center - half_extents, center + half_extents);
+    }
 
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
-    for (auto const &[position, meshes] : m_chunk_meshes) {
-        if (position.x < player_chunk.x - g_render_distance_horizontal
-            || position.x > player_chunk.x + g_render_distance_horizontal
-            || position.y < player_chunk.y - g_render_distance_vertical
-            || position.y > player_chunk.y + g_render_distance_vertical
-            || position.z < player_chunk.z - g_render_distance_horizontal
-            || position.z > player_chunk.z + g_render_distance_horizontal)
-            continue;
-        glBindBuffer(GL_ARRAY_BUFFER, meshes.solid_mesh.vertex_buffer);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshes.solid_mesh.index_buffer);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, position));
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, uv));
-        glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, color));
-        glVertexAttribPointer(3, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, light));
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glEnableVertexAttribArray(3);
-        glDrawElements(GL_TRIANGLES, meshes.translucent_mesh.index_count, GL_UNSIGNED_INT, nullptr);
+    // the draw blocks are added as the passes are built
+    m_uniforms.draw_blocks.clear();
+    m_uniforms.draw_count = 0;
+
+    // chunks further than far_distance are drawn with the cheaper far permutation, when the material has one
+    auto const far_distance = static_cast<int>(engine::config().rendering.far_distance);
+    engine::rendering::opengl::Material::Program const *programs[2] = {};
+    auto const add_chunk = [&](Pass &pass, bool ordered, std::size_t i, engine::rendering::opengl::MeshHandle const &mesh) {
+        if (!m_culling.visible[i] || mesh.index_count == 0) return;
+
+        auto const &position = m_culling.positions[i];
+        bool const far = m_far_permutation && far_distance
+            && std::max({ std::abs(position.x - player_chunk.x), std::abs(position.y - player_chunk.y), std::abs(position.z - player_chunk.z) }) > far_distance;
+        if (!programs[far])
+            programs[far] = &m_terrain->program(*m_programs, far ? m_far_permutation : 0);
+
+        auto &draws = pass.batch(*programs[far], ordered);
+        add_draw(draws, mesh);
+        if (programs[far]->per_draw)
+            draws.blocks.push_back(add_draw_block({
+                .chunk_origin = chunk_origin(position),
+                .lod = far ? 1.0f : 0.0f,
+                // chunks don't fade in yet
+                .fade = 1.0f,
+                .padding = {},
+            }));
+    };
+
+    m_solid_pass.clear();
+    m_translucent_pass.clear();
+    // solid chunks front to back so the nearest ones occlude the rest early, translucent ones back to front so they blend over what's behind
+    for (std::size_t i = 0; i < m_culling.meshes.size(); ++i)
+        add_chunk(m_solid_pass, false, i, m_culling.meshes[i]->solid_mesh);
+    for (std::size_t i = m_culling.meshes.size(); i-- > 0;)
+        add_chunk(m_translucent_pass, true, i, m_culling.meshes[i]->translucent_mesh);
+
+    // written once and bound for every draw of the frame
+    engine::rendering::opengl::FrameBlock const frame {
+        .view = view_matrix,
+        .projection = projection_matrix,
+        .camera_position = actual_position,
+        .time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_uniforms.start).count(),
+    };
+    auto const frame_offset = m_staging->write(&frame, sizeof(frame), m_uniforms.alignment);
+    glBindBufferRange(GL_UNIFORM_BUFFER, engine::rendering::opengl::FrameBlock::binding, m_staging->buffer(), static_cast<GLintptr>(frame_offset), sizeof(frame));
+
+    // the draw blocks are bound one at a time by draw_pass, from wherever their slice landed
+    m_uniforms.slices.clear();
+    auto const slice_size = m_uniforms.blocks_per_slice * m_uniforms.draw_stride;
+    for (std::size_t offset = 0; offset < m_uniforms.draw_blocks.size(); offset += slice_size) {
+        auto const size = std::min(slice_size, m_uniforms.draw_blocks.size() - offset);
+        m_uniforms.slices.push_back(m_staging->write(m_uniforms.draw_blocks.data() + offset, size, m_uniforms.alignment));
     }
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
-    for (auto const &[p, meshes] : m_chunk_meshes) {
-        glBindBuffer(GL_ARRAY_BUFFER, meshes.solid_mesh.vertex_buffer);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshes.solid_mesh.index_buffer);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, position));
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, uv));
-        glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, color));
-        glVertexAttribPointer(3, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rendering::Vertex), (void *)offsetof(rendering::Vertex, light));
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glEnableVertexAttribArray(3);
-        glDrawElements(GL_TRIANGLES, meshes.solid_mesh.index_count, GL_UNSIGNED_INT, nullptr);
-    }
+    draw_pass(m_solid_pass);
+
+    // translucent faces are tested against the solid ones but don't hide each other, they're blended back to front instead
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    draw_pass(m_translucent_pass);
+    glDisable(GL_BLEND);
+    // glClear only clears depth while it can be written
+    glDepthMask(GL_TRUE);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     glUseProgram(0);
 
+    // after the last draw, so the copies feeding it are all behind the fence
+    m_staging->end_frame();
+
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-    // swap the buffer (present to the window surface)
-    game().window().opengl().swap_buffers();
+    if (!m_offscreen.framebuffer) {
+        // swap the buffer (present to the window surface)
+        game().window().opengl().swap_buffers();
+        return;
+    }
+
+    auto const &headless = engine::config().rendering.headless;
+    ++m_offscreen.frames;
+    if (headless.dump_interval && m_offscreen.frames % headless.dump_interval == 0)
+        dump_frame();
+    if (headless.frames && m_offscreen.frames >= headless.frames) {
+        glFinish();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - m_offscreen.start;
+        SPDLOG_INFO("rendered {} frames in {:.3f}s, {:.1f} frames per second", m_offscreen.frames, elapsed.count(), static_cast<double>(m_offscreen.frames) / elapsed.count());
+        game().running = false;
+    }
+}
+
+void engine::rendering::opengl::Renderer::setup_offscreen()
+{
+    auto const &headless = engine::config().rendering.headless;
+    auto const width = static_cast<GLsizei>(headless.width);
+    auto const height = static_cast<GLsizei>(headless.height);
+
+    glGenRenderbuffers(1, &m_offscreen.color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_offscreen.color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &m_offscreen.depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_offscreen.depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // stays bound for as long as the renderer lives, every pass draws into it
+    glGenFramebuffers(1, &m_offscreen.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_offscreen.framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_offscreen.color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_offscreen.depth);
+    if (auto const status = glCheckFramebufferStatus(GL_FRAMEBUFFER); status != GL_FRAMEBUFFER_COMPLETE)
+        utils::show_error("OpenGL Error."sv, fmt::format("Offscreen framebuffer is incomplete (0x{:x})", status));
+
+    glViewport(0, 0, width, height);
+    m_offscreen.start = std::chrono::steady_clock::now();
+    SPDLOG_INFO("rendering headless to a {}x{} framebuffer", width, height);
+}
+
+#include <engine/assets/Image.hpp>
+
+void engine::rendering::opengl::Renderer::dump_frame() const
+{
+    auto const &headless = engine::config().rendering.headless;
+    std::size_t const row_size = headless.width * 4;
+
+    std::vector<std::byte> pixels(row_size * headless.height);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, static_cast<GLsizei>(headless.width), static_cast<GLsizei>(headless.height), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    engine::assets::Image image("frame"sv);
+    image.create(headless.width, headless.height);
+    {
+        // the framebuffer's first row is the bottom one
+        auto const lock = image.lock();
+        for (std::size_t y = 0; y < headless.height; ++y)
+            std::memcpy(lock.pixels() + y * image.pitch(), pixels.data() + (headless.height - 1 - y) * row_size, row_size);
+    }
+
+    auto const folder = engine::config().folders.cache / "frames";
+    std::filesystem::create_directories(folder);
+    image.save(folder / fmt::format("{:06}.png", m_offscreen.frames));
 }
 
 #include <engine/ecs/components/ChunkData.hpp>
 #include <engine/ecs/components/ChunkPosition.hpp>
 #include <engine/ecs/components/Dirty.hpp>
+#include <engine/world/chunk_blocks.hpp>
 
-static auto get_sorted_indices(engine::rendering::Mesh const &mesh)
+static auto get_sorted_indices(engine::rendering::Mesh const &mesh, engine::components::ChunkPosition const &chunk_position)
 {
+    // the mesh is in chunk coordinates, so is the camera here
+    auto const camera = g_camera.position - chunk_origin(chunk_position);
+
     auto result = mesh.indices;
     using face_t = std::array<std::uint32_t, 3>;
     auto begin = reinterpret_cast<face_t *>(result.data());
     auto end = reinterpret_cast<face_t *>(result.data() + result.size());
 
-    std::sort(begin, end, [&vertices = mesh.vertices](face_t const &lhs, face_t const &rhs) {
+    std::sort(begin, end, [&vertices = mesh.vertices, camera](face_t const &lhs, face_t const &rhs) {
         auto const lhs_center = (vertices[lhs[0]].position + vertices[lhs[1]].position + vertices[lhs[2]].position) / 3.0f;
         auto const rhs_center = (vertices[rhs[0]].position + vertices[rhs[1]].position + vertices[rhs[2]].position) / 3.0f;
-        auto const lhs_distance = glm::length(lhs_center - g_camera.position);
-        auto const rhs_distance = glm::length(rhs_center - g_camera.position);
+        auto const lhs_distance = glm::length(lhs_center - camera);
+        auto const rhs_distance = glm::length(rhs_center - camera);
         return lhs_distance < rhs_distance;
     });
 
@@ -338,65 +455,248 @@ void engine::rendering::opengl::Renderer::update()
         auto p_mesh = m_chunk_meshes.find(chunk_position);
         auto p_data = m_translucent_mesh_data.find(chunk_position);
         if (p_mesh != m_chunk_meshes.end() && p_data != m_translucent_mesh_data.end()) {
-            auto const sorted_indices = get_sorted_indices(p_data->second);
+            auto const sorted_indices = get_sorted_indices(p_data->second, chunk_position);
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p_mesh->second.translucent_mesh.index_buffer);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sorted_indices.size() * sizeof(*sorted_indices.data()), sorted_indices.data(), GL_STREAM_DRAW);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            // same mesh, same number of indices, they fit where they are
+            m_index_arena->upload(p_mesh->second.translucent_mesh.indices, sorted_indices.data(), sorted_indices.size());
         }
     });
 
-    registry.view<engine::components::ChunkPosition, engine::components::ChunkData, engine::components::Dirty>().each([&](entt::entity chunk, auto const &chunk_position, auto const &chunk_data) {
-        auto it = m_chunk_meshes.find(chunk_position);
-        if (it == m_chunk_meshes.end()) {
+    // nearest to the camera first, what doesn't fit in this frame's budget stays dirty and keeps its old mesh until a later frame
+    m_pending_meshes.clear();
+    registry.view<engine::components::ChunkPosition, engine::components::Dirty>().each([&](entt::entity chunk, auto const &chunk_position) {
+        m_pending_meshes.emplace_back(chunk, chunk_position);
+    });
+    std::ranges::sort(m_pending_meshes, {}, [center = m_culling.center](auto const &pending) {
+        std::int64_t const x = pending.second.x - center.x;
+        std::int64_t const y = pending.second.y - center.y;
+        std::int64_t const z = pending.second.z - center.z;
+        return x * x + y * y + z * z;
+    });
 
-            GLuint buffers[4];
-            glGenBuffers(std::size(buffers), buffers);
-            std::tie(it, std::ignore) = m_chunk_meshes.emplace(chunk_position,
-                Renderer::ChunkMeshes {
-                    .translucent_mesh = rendering::opengl::MeshHandle { buffers[0], buffers[1], 0 },
-                    .solid_mesh = rendering::opengl ::MeshHandle { buffers[2], buffers[3], 0 } });
-        }
+    auto const &config = engine::config();
+    auto const start = std::chrono::steady_clock::now();
+    std::size_t uploaded = 0;
+    for (std::size_t i = 0; i < m_pending_meshes.size(); ++i) {
+        if (i != 0 && (uploaded >= config.rendering.upload_budget || std::chrono::steady_clock::now() - start >= std::chrono::milliseconds { config.rendering.upload_time_budget }))
+            break;
+        uploaded += mesh_chunk(registry, m_pending_meshes[i].first, m_pending_meshes[i].second);
+    }
 
-        auto const solid_mesh = game().generate_solid_mesh(chunk_position, chunk_data);
-        auto const translucent_mesh = game().generate_translucent_mesh(chunk_position);
+    for (auto *const arena : { &*m_vertex_arena, &*m_index_arena }) {
+        arena->trim(trimmed_per_frame);
+        auto const stats = arena->stats();
+        if (stats.free_ranges >= compaction_free_ranges && stats.fragmentation() >= compaction_fragmentation)
+            arena->compact();
+    }
+}
 
-        auto const sorted_indices = get_sorted_indices(translucent_mesh);
+std::size_t engine::rendering::opengl::Renderer::mesh_chunk(entt::registry &registry, entt::entity chunk, engine::components::ChunkPosition const &chunk_position)
+{
+    auto it = m_chunk_meshes.find(chunk_position);
+    if (it == m_chunk_meshes.end()) {
+        std::tie(it, std::ignore) = m_chunk_meshes.emplace(chunk_position, Renderer::ChunkMeshes {});
+        m_culling.stale = true;
+    }
 
-        // TODO: Vertex deduplication?
+    auto const blocks = engine::world::chunk_blocks(registry, chunk);
+    auto const solid_mesh = game().generate_solid_mesh(blocks, engine::world::chunk_payloads(registry, chunk));
+    it->second.connectivity = engine::world::face_connectivity(blocks, game().block_registry());
+    it->second.occluder = std::ranges::all_of(blocks, [&block_types = game().block_registry()](engine::Block const &block) {
+        return block.type_id != entt::null && block_types.get(static_cast<entt::entity>(block.type_id)).opaque;
+    });
+    auto const translucent_mesh = game().generate_translucent_mesh(chunk_position);
 
-        glBindBuffer(GL_ARRAY_BUFFER, it->second.solid_mesh.vertex_buffer);
-        glBufferData(GL_ARRAY_BUFFER, solid_mesh.vertices.size() * sizeof(*solid_mesh.vertices.data()), solid_mesh.vertices.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, it->second.solid_mesh.index_buffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, solid_mesh.indices.size() * sizeof(*solid_mesh.indices.data()), solid_mesh.indices.data(), GL_DYNAMIC_DRAW);
+    auto const sorted_indices = get_sorted_indices(translucent_mesh, chunk_position);
 
-        it->second.solid_mesh.index_count = solid_mesh.indices.size();
+    // TODO: Vertex deduplication?
 
-        glBindBuffer(GL_ARRAY_BUFFER, it->second.solid_mesh.vertex_buffer);
-        glBufferData(GL_ARRAY_BUFFER, translucent_mesh.vertices.size() * sizeof(*translucent_mesh.vertices.data()), translucent_mesh.vertices.data(), GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, it->second.solid_mesh.index_buffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sorted_indices.size() * sizeof(*sorted_indices.data()), sorted_indices.data(), GL_STREAM_DRAW);
+    upload_mesh(it->second.solid_mesh, solid_mesh.vertices, solid_mesh.indices);
+    upload_mesh(it->second.translucent_mesh, translucent_mesh.vertices, sorted_indices);
+    auto const uploaded = (solid_mesh.vertices.size() + translucent_mesh.vertices.size()) * sizeof(rendering::Vertex)
+        + (solid_mesh.indices.size() + sorted_indices.size()) * sizeof(std::uint32_t);
 
-        it->second.solid_mesh.index_count = sorted_indices.size();
+    if (auto mesh_data = m_translucent_mesh_data.find(chunk_position); mesh_data != m_translucent_mesh_data.end())
+        mesh_data->second = std::move(translucent_mesh);
+    else
+        m_translucent_mesh_data.emplace(chunk_position, std::move(translucent_mesh));
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    registry.remove<engine::components::Dirty>(chunk);
+    return uploaded;
+}
 
-        if (auto mesh_data = m_translucent_mesh_data.find(chunk_position); mesh_data != m_translucent_mesh_data.end())
-            mesh_data->second = std::move(translucent_mesh);
-        else
-            m_translucent_mesh_data.emplace(chunk_position, std::move(translucent_mesh));
+void engine::rendering::opengl::Renderer::sort_chunks(engine::components::ChunkPosition center)
+{
+    m_culling.stale = false;
+    m_culling.center = center;
+    m_culling.horizontal_distance = g_render_distance_horizontal;
+    m_culling.vertical_distance = g_render_distance_vertical;
+
+    // squared distance in chunks, there are few enough of them to counting sort
+    auto const distance = [center](engine::components::ChunkPosition const &position) -> std::int64_t {
+        if (position.dimension != center.dimension) return -1;
+        std::int64_t const x = position.x - center.x;
+        std::int64_t const y = position.y - center.y;
+        std::int64_t const z = position.z - center.z;
+        if (std::abs(x) > g_render_distance_horizontal || std::abs(y) > g_render_distance_vertical || std::abs(z) > g_render_distance_horizontal)
+            return -1;
+        return x * x + y * y + z * z;
+    };
+
+    // buckets[d + 1] counts the chunks at distance d, then buckets[d] becomes where they start
+    std::int64_t const horizontal = g_render_distance_horizontal;
+    std::int64_t const vertical = g_render_distance_vertical;
+    m_culling.buckets.assign(static_cast<std::size_t>(2 * horizontal * horizontal + vertical * vertical + 2), 0);
+    for (auto const &[position, meshes] : m_chunk_meshes)
+        if (auto const d = distance(position); d >= 0) ++m_culling.buckets[d + 1];
+    std::partial_sum(m_culling.buckets.begin(), m_culling.buckets.end(), m_culling.buckets.begin());
+
+    constexpr auto chunk_size = static_cast<float>(engine::components::ChunkData::chunk_size);
+    auto const count = m_culling.buckets.back();
+    m_culling.x.resize(count);
+    m_culling.y.resize(count);
+    m_culling.z.resize(count);
+    m_culling.meshes.resize(count);
+    m_culling.positions.resize(count);
+    m_culling.indices.clear();
+    for (auto const &[position, meshes] : m_chunk_meshes) {
+        auto const d = distance(position);
+        if (d < 0) continue;
+        auto const i = m_culling.buckets[d]++;
+        // block models are centred on their position, so a chunk starts half a block before its first block
+        m_culling.x[i] = position.x * chunk_size + (chunk_size - 1.0f) / 2.0f;
+        m_culling.y[i] = position.y * chunk_size + (chunk_size - 1.0f) / 2.0f;
+        m_culling.z[i] = position.z * chunk_size + (chunk_size - 1.0f) / 2.0f;
+        m_culling.meshes[i] = &meshes;
+        m_culling.positions[i] = position;
+        m_culling.indices.emplace(position, i);
+    }
+}
 
-        registry.remove<engine::components::Dirty>(chunk);
-    });
+void engine::rendering::opengl::Renderer::cull_unreachable(std::uint32_t start)
+{
+    // indexed by the bit of the face in engine::Sides, the opposite face is the next or previous bit
+    constexpr glm::i32vec3 directions[6] = { { 0, 0, -1 }, { 0, 0, 1 }, { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+
+    auto const count = m_culling.meshes.size();
+    m_culling.reached.assign(count, false);
+    m_culling.entered.resize(count);
+    m_culling.travelled.resize(count);
+    m_culling.queue.clear();
+
+    m_culling.reached[start] = true;
+    m_culling.travelled[start] = engine::Sides::NONE;
+    m_culling.queue.push_back(start);
+    for (std::size_t head = 0; head < m_culling.queue.size(); ++head) {
+        auto const current = m_culling.queue[head];
+        auto const &position = m_culling.positions[current];
+        for (int face = 0; face < 6; ++face) {
+            auto const out = static_cast<engine::Sides>(1 << face);
+            auto const back = static_cast<engine::Sides>(1 << (face ^ 1));
+            // going back towards the camera can only reach chunks behind what was already seen
+            if (m_culling.travelled[current] & back) continue;
+            // the camera sees out of its own chunk through every face
+            if (current != start && !m_culling.meshes[current]->connectivity.connects(m_culling.entered[current], out)) continue;
+
+            auto const next = m_culling.indices.find(engine::components::ChunkPosition {
+                position.x + directions[face].x,
+                position.y + directions[face].y,
+                position.z + directions[face].z,
+                position.dimension,
+            });
+            if (next == m_culling.indices.end() || m_culling.reached[next->second] || !m_culling.visible[next->second]) continue;
+
+            m_culling.reached[next->second] = true;
+            m_culling.entered[next->second] = back;
+            m_culling.travelled[next->second] = static_cast<engine::Sides>(m_culling.travelled[current] | out);
+            m_culling.queue.push_back(next->second);
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+        m_culling.visible[i] &= m_culling.reached[i];
+}
+
+void engine::rendering::opengl::Renderer::upload_mesh(engine::rendering::opengl::MeshHandle &handle, engine::rendering::Mesh::vertex_vector const &vertices, engine::rendering::Mesh::index_vector const &indices)
+{
+    // remeshed chunks usually come back about the same size, they reuse their ranges whenever they fit
+    if (handle.vertices == BufferArena::null_handle) {
+        handle.vertices = m_vertex_arena->allocate(vertices.size());
+        handle.indices = m_index_arena->allocate(indices.size());
+    } else {
+        m_vertex_arena->resize(handle.vertices, vertices.size());
+        m_index_arena->resize(handle.indices, indices.size());
+    }
+    handle.index_count = static_cast<std::uint32_t>(indices.size());
+
+    m_vertex_arena->upload(handle.vertices, vertices.data(), vertices.size());
+    m_index_arena->upload(handle.indices, indices.data(), indices.size());
+}
+
+void engine::rendering::opengl::Renderer::add_draw(DrawList &draws, engine::rendering::opengl::MeshHandle const &handle) const
+{
+    if (handle.index_count == 0) return;
+
+    // indices are relative to the mesh's first vertex
+    draws.counts.push_back(static_cast<GLsizei>(handle.index_count));
+    draws.offsets.push_back(reinterpret_cast<void const *>(m_index_arena->offset(handle.indices) * sizeof(std::uint32_t)));
+    draws.base_vertices.push_back(static_cast<GLint>(m_vertex_arena->offset(handle.vertices)));
+}
+
+std::uint32_t engine::rendering::opengl::Renderer::add_draw_block(engine::rendering::opengl::DrawBlock const &block)
+{
+    auto const offset = m_uniforms.draw_blocks.size();
+    m_uniforms.draw_blocks.resize(offset + m_uniforms.draw_stride);
+    std::memcpy(m_uniforms.draw_blocks.data() + offset, &block, sizeof(block));
+    return m_uniforms.draw_count++;
+}
+
+void engine::rendering::opengl::Renderer::draw_pass(Pass const &pass) const
+{
+    for (std::size_t i = 0; i < pass.used; ++i) {
+        auto const &[program, draws] = pass.batches[i];
+        glUseProgram(program->id);
+        if (!program->per_draw) {
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, draws.counts.data(), GL_UNSIGNED_INT, draws.offsets.data(), static_cast<GLsizei>(draws.counts.size()), draws.base_vertices.data());
+            continue;
+        }
+
+        // without gl_DrawID a block can't be picked in a multi draw, each draw is on its own
+        for (std::size_t j = 0; j < draws.counts.size(); ++j) {
+            auto const block = draws.blocks[j];
+            auto const offset = m_uniforms.slices[block / m_uniforms.blocks_per_slice] + block % m_uniforms.blocks_per_slice * m_uniforms.draw_stride;
+            glBindBufferRange(GL_UNIFORM_BUFFER, engine::rendering::opengl::DrawBlock::binding, m_staging->buffer(), static_cast<GLintptr>(offset), sizeof(engine::rendering::opengl::DrawBlock));
+            glDrawElementsBaseVertex(GL_TRIANGLES, draws.counts[j], GL_UNSIGNED_INT, draws.offsets[j], draws.base_vertices[j]);
+        }
+    }
+}
+
+engine::rendering::opengl::Renderer::DrawList &engine::rendering::opengl::Renderer::Pass::batch(engine::rendering::opengl::Material::Program const &program, bool ordered)
+{
+    // a handful of programs at most, a linear search beats anything fancier
+    auto const first = ordered && used ? used - 1 : 0;
+    for (std::size_t i = first; i < used; ++i)
+        if (batches[i].program == &program) return batches[i].draws;
+
+    if (used == batches.size())
+        batches.emplace_back();
+    batches[used].program = &program;
+    return batches[used++].draws;
 }
 
 engine::rendering::opengl::Renderer::~Renderer()
 {
     ImGui_ImplOpenGL3_Shutdown();
+    m_vertex_arena.reset();
+    m_index_arena.reset();
+    m_staging.reset();
     glDeleteVertexArrays(1, &m_vao);
-    glDeleteProgram(m_shader);
-#if 0
-    glDeleteTextures(1, &m_textures.texture2d_array);
-#endif
+    if (m_terrain) m_terrain->release();
+    if (m_offscreen.framebuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &m_offscreen.framebuffer);
+        glDeleteRenderbuffers(1, &m_offscreen.color);
+        glDeleteRenderbuffers(1, &m_offscreen.depth);
+    }
+    glDeleteTextures(1, &m_texture);
 }
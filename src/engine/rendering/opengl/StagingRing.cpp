@@ -0,0 +1,108 @@
+#include <engine/rendering/opengl/StagingRing.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+    // keeps the copies aligned for the driver
+    constexpr std::size_t alignment = 16;
+    constexpr GLuint64 wait_timeout = 1'000'000'000; // nanoseconds
+}
+
+engine::rendering::opengl::StagingRing::StagingRing(std::size_t capacity)
+    : m_capacity(capacity)
+{
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glBufferData(GL_COPY_READ_BUFFER, m_capacity, nullptr, GL_STREAM_COPY);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+engine::rendering::opengl::StagingRing::~StagingRing()
+{
+    for (auto const &region : m_fenced)
+        glDeleteSync(region.fence);
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void engine::rendering::opengl::StagingRing::copy(GLuint destination, std::size_t offset, void const *data, std::size_t size)
+{
+    if (size == 0) return;
+
+    if (size > m_capacity) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return;
+    }
+
+    auto const begin = write(data, size, alignment);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, begin, offset, size);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+std::size_t engine::rendering::opengl::StagingRing::write(void const *data, std::size_t size, std::size_t alignment)
+{
+    // a region never wraps, anything larger could only be written past the end of the buffer
+    assert(size <= m_capacity);
+
+    auto begin = (m_head + alignment - 1) / alignment * alignment;
+    if (begin + size > m_capacity) {
+        // the open region can't wrap around, it's fenced where it is and a new one starts at the beginning
+        end_frame();
+        begin = 0;
+        m_open_begin = 0;
+    }
+    reserve(begin, begin + size);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    bool written = false;
+    if (auto *const mapped = glMapBufferRange(GL_COPY_READ_BUFFER, begin, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)) {
+        std::memcpy(mapped, data, size);
+        written = glUnmapBuffer(GL_COPY_READ_BUFFER);
+        // the contents were lost, the range is still reserved so it's written again without mapping
+        if (!written) SPDLOG_WARN("staging buffer was corrupted while mapped, writing it again");
+    }
+    if (!written)
+        glBufferSubData(GL_COPY_READ_BUFFER, begin, size, data);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    m_head = begin + size;
+    return begin;
+}
+
+void engine::rendering::opengl::StagingRing::end_frame()
+{
+    if (m_head == m_open_begin) return;
+
+    m_fenced.push_back(Region {
+        .begin = m_open_begin,
+        .end = m_head,
+        .fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+    });
+    m_open_begin = m_head;
+}
+
+void engine::rendering::opengl::StagingRing::reserve(std::size_t begin, std::size_t end)
+{
+    // regions complete in order, waiting on the newest one overlapping means every older one is done too
+    auto const newest = std::find_if(m_fenced.rbegin(), m_fenced.rend(), [&](Region const &region) {
+        return region.begin < end && begin < region.end;
+    });
+    if (newest == m_fenced.rend()) return;
+
+    while (glClientWaitSync(newest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait_timeout) == GL_TIMEOUT_EXPIRED)
+        SPDLOG_WARN("still waiting for the gpu to release the staging buffer");
+
+    auto const last = newest.base();
+    for (auto it = m_fenced.begin(); it != last; ++it)
+        glDeleteSync(it->fence);
+    m_fenced.erase(m_fenced.begin(), last);
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include <engine/system/async_io.hpp>
+#include <engine/system/positioned_io.hpp>
+#include <utils/thread_pool.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <condition_variable>
+#include <mutex>
+
+std::future<std::vector<std::byte>> engine::system::IAsyncIO::read(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::size_t size)
+{
+    // std::function needs a copyable callable
+    auto promise = std::make_shared<std::promise<std::vector<std::byte>>>();
+    auto future = promise->get_future();
+    queue_read(fp, offset, size, [promise](std::error_code error, std::span<std::byte const> bytes) {
+        if (error)
+            promise->set_exception(std::make_exception_ptr(std::system_error(error, "asynchronous read failed")));
+        else
+            promise->set_value(std::vector<std::byte>(bytes.begin(), bytes.end()));
+    });
+    return future;
+}
+
+std::future<void> engine::system::IAsyncIO::write(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::vector<std::byte> data)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    queue_write(fp, offset, std::move(data), [promise](std::error_code error) {
+        if (error)
+            promise->set_exception(std::make_exception_ptr(std::system_error(error, "asynchronous write failed")));
+        else
+            promise->set_value();
+    });
+    return future;
+}
+
+namespace {
+
+    class ThreadPoolIO;
+
+    struct Request {
+        ThreadPoolIO *owner;
+        std::FILE *fp;
+        std::uint64_t offset;
+        std::size_t size;
+        // the callbacks may be empty, they can't tell which one it is
+        bool is_write;
+        // only for writes
+        std::vector<std::byte> data;
+        engine::system::IAsyncIO::ReadCallback on_read;
+        engine::system::IAsyncIO::WriteCallback on_write;
+    };
+
+    class ThreadPoolIO final : public engine::system::IAsyncIO {
+    public:
+        explicit ThreadPoolIO(std::uint32_t threads)
+            : m_pool(&ThreadPoolIO::run, threads)
+        {
+        }
+
+        ~ThreadPoolIO() override
+        {
+            submit();
+            wait_idle();
+            m_pool.stop();
+        }
+
+        void queue_read(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::size_t size, ReadCallback callback) override
+        {
+            std::scoped_lock lock { m_mutex };
+            m_queued.push_back(Request { this, fp, offset, size, false, {}, std::move(callback), {} });
+        }
+
+        void queue_write(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::vector<std::byte> data, WriteCallback callback) override
+        {
+            std::scoped_lock lock { m_mutex };
+            auto const size = data.size();
+            m_queued.push_back(Request { this, fp, offset, size, true, std::move(data), {}, std::move(callback) });
+        }
+
+        void submit() override
+        {
+            std::vector<Request> requests;
+            {
+                std::scoped_lock lock { m_mutex };
+                requests.swap(m_queued);
+                m_in_flight += requests.size();
+            }
+            for (auto &request : requests)
+                (void)m_pool.submit(std::move(request));
+        }
+
+        void wait_idle() override
+        {
+            std::unique_lock lock { m_mutex };
+            m_idle.wait(lock, [this] { return m_in_flight == 0; });
+        }
+
+    private:
+        static void run(Request request)
+        {
+            try {
+                if (request.is_write) {
+                    std::error_code error;
+                    try {
+                        engine::system::write_at(request.fp, request.offset, request.data);
+                    } catch (std::system_error const &e) {
+                        error = e.code();
+                    }
+                    if (request.on_write) request.on_write(error);
+                } else {
+                    std::vector<std::byte> buffer(request.size);
+                    std::error_code error;
+                    try {
+                        buffer.resize(engine::system::read_at(request.fp, request.offset, buffer));
+                    } catch (std::system_error const &e) {
+                        error = e.code();
+                        buffer.clear();
+                    }
+                    if (request.on_read) request.on_read(error, buffer);
+                }
+            } catch (std::exception const &e) {
+                SPDLOG_ERROR("asynchronous I/O callback failed: {}", e.what());
+            }
+
+            request.owner->finished();
+        }
+
+        void finished()
+        {
+            {
+                std::scoped_lock lock { m_mutex };
+                --m_in_flight;
+            }
+            m_idle.notify_all();
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_idle;
+        std::vector<Request> m_queued;
+        std::size_t m_in_flight = 0;
+
+        utils::thread_pool<void, Request> m_pool;
+    };
+
+}
+
+std::unique_ptr<engine::system::IAsyncIO> engine::system::make_thread_pool_io(std::uint32_t threads)
+{
+    return std::make_unique<ThreadPoolIO>(threads);
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <engine/binary_archive.hpp>
+#include <engine/errors/CorruptedData.hpp>
+#include <engine/world/ChunkCodec.hpp>
+#include <utils/endian.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+namespace {
+    constexpr std::size_t block_count = engine::components::ChunkData::block_count;
+    constexpr std::size_t blocks_size = sizeof(engine::components::ChunkData::blocks);
+
+    static_assert(std::is_trivially_copyable_v<engine::Block>, "blocks are written and mapped as they are in memory");
+}
+
+static void check_payloads(engine::BlockPayloads const &payloads)
+{
+    if (payloads.size() > block_count) {
+        SPDLOG_ERROR("chunk payload has {} block payloads", payloads.size());
+        throw engine::errors::CorruptedData();
+    }
+    for (std::size_t i = 0; i < payloads.size(); ++i) {
+        auto const index = payloads.entries[i].index;
+        if (index >= block_count || (i != 0 && index <= payloads.entries[i - 1].index)) {
+            SPDLOG_ERROR("chunk payload has block payloads out of order");
+            throw engine::errors::CorruptedData();
+        }
+    }
+}
+
+engine::Block const *engine::world::view_chunk(std::span<std::byte const> payload, engine::BlockPayloads &payloads)
+{
+    auto const header = read_payload_header(payload);
+    if (header.compression != Compression::none || header.decoded_size != blocks_size) return nullptr;
+
+    engine::BinaryInputArchive archive(payload.subspan(PayloadHeader::size));
+    // blocks written with the other byte order have to be swapped by decode_chunk
+    if (archive.swapped()) return nullptr;
+
+    auto const blocks = archive.view_bytes(blocks_size);
+    if (reinterpret_cast<std::uintptr_t>(blocks.data()) % alignof(engine::Block) != 0) return nullptr;
+
+    archive >> payloads;
+    check_payloads(payloads);
+    return reinterpret_cast<engine::Block const *>(blocks.data());
+}
+
+engine::world::PayloadHeader engine::world::read_payload_header(std::span<std::byte const> payload)
+{
+    if (payload.size() < PayloadHeader::size) {
+        SPDLOG_ERROR("chunk payload is truncated ({} bytes)", payload.size());
+        throw engine::errors::CorruptedData();
+    }
+
+    return PayloadHeader {
+        .compression = static_cast<Compression>(payload[0]),
+        .decoded_size = utils::load_le<std::uint32_t>(payload.data() + 4),
+    };
+}
+
+std::vector<std::byte> engine::world::encode_chunk(engine::components::ChunkData const &chunk, Compression compression)
+{
+    std::vector<std::byte> result(PayloadHeader::size);
+    result[0] = static_cast<std::byte>(compression);
+    utils::store_le<std::uint32_t>(result.data() + 4, blocks_size);
+
+    engine::BinaryOutputArchive archive(result);
+    switch (compression) {
+    case Compression::none:
+        // the blocks go out in a single memcpy, right after the archive header
+        archive << chunk;
+        break;
+    case Compression::rle:
+        // u16 run length + block
+        for (std::size_t i = 0; i < block_count;) {
+            std::size_t run = 1;
+            while (i + run < block_count && chunk.blocks[i + run] == chunk.blocks[i])
+                ++run;
+
+            archive << static_cast<std::uint16_t>(run - 1) << chunk.blocks[i];
+            i += run;
+        }
+        archive << chunk.payloads;
+        break;
+    }
+    return result;
+}
+
+void engine::world::decode_chunk(std::span<std::byte const> payload, engine::components::ChunkData &chunk)
+{
+    auto const header = read_payload_header(payload);
+    if (header.decoded_size != blocks_size) {
+        SPDLOG_ERROR("chunk payload has {} bytes of blocks, expected {}", header.decoded_size, blocks_size);
+        throw engine::errors::CorruptedData();
+    }
+    if (header.compression != Compression::none && header.compression != Compression::rle) {
+        SPDLOG_ERROR("unknown chunk compression {}", static_cast<int>(header.compression));
+        throw engine::errors::CorruptedData();
+    }
+
+    engine::BinaryInputArchive archive(payload.subspan(PayloadHeader::size));
+    if (header.compression == Compression::none) {
+        archive >> chunk;
+    } else {
+        for (std::size_t i = 0; i < block_count;) {
+            std::uint16_t run;
+            engine::Block block;
+            archive >> run >> block;
+            if (i + run + 1u > block_count) {
+                SPDLOG_ERROR("run length encoded chunk payload has more than {} blocks", block_count);
+                throw engine::errors::CorruptedData();
+            }
+            std::fill_n(chunk.blocks + i, run + 1u, block);
+            i += run + 1u;
+        }
+        archive >> chunk.payloads;
+    }
+    check_payloads(chunk.payloads);
+}
\ No newline at end of file
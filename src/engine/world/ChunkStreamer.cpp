@@ -0,0 +1,117 @@
+#include <engine/errors/CorruptedData.hpp>
+#include <engine/world/ChunkCodec.hpp>
+#include <engine/world/ChunkStreamer.hpp>
+
+#include <spdlog/spdlog.h>
+
+engine::world::ChunkStreamer::~ChunkStreamer()
+{
+    // the jobs and the callbacks point back to us
+    {
+        std::scoped_lock lock { m_mutex };
+        m_stopping = true;
+    }
+    m_io->submit();
+    {
+        std::unique_lock lock { m_mutex };
+        m_idle.wait(lock, [this] { return m_loading == 0; });
+    }
+    m_pool.stop();
+    m_io->wait_idle();
+}
+
+void engine::world::ChunkStreamer::push_result(Result result)
+{
+    {
+        std::scoped_lock lock { m_mutex };
+        m_finished.push_back(std::move(result));
+        --m_loading;
+    }
+    m_idle.notify_all();
+}
+
+void engine::world::ChunkStreamer::request(engine::components::ChunkPosition const &position)
+{
+    if (!m_pending.insert(position).second) return;
+
+    {
+        std::scoped_lock lock { m_mutex };
+        ++m_loading;
+    }
+    // finding the chunk opens and maps its region, it can't happen on the game thread
+    (void)m_pool.submit(this, engine::components::ChunkPosition { position }, std::optional<std::vector<std::byte>> {});
+}
+
+void engine::world::ChunkStreamer::work(ChunkStreamer *streamer, engine::components::ChunkPosition position, std::optional<std::vector<std::byte>> payload)
+{
+    if (payload)
+        streamer->decode(position, *payload);
+    else
+        streamer->load(position);
+}
+
+void engine::world::ChunkStreamer::load(engine::components::ChunkPosition const &position)
+{
+    std::optional<RegionStorage::Location> location;
+    try {
+        // mapping costs no I/O up front, the pages are faulted in when the chunk is meshed
+        if (m_storage->compression() == Compression::none) {
+            if (auto mapped = m_storage->map(position))
+                return push_result(Result { position, std::move(*mapped) });
+        }
+        location = m_storage->locate(position);
+    } catch (engine::errors::CorruptedData const &) {
+        SPDLOG_WARN("discarding corrupted chunk ({}, {}, {}) of dimension {}", position.x, position.y, position.z, position.dimension);
+    } catch (std::system_error const &e) {
+        SPDLOG_ERROR("failed to open the region of chunk ({}, {}, {}): {}", position.x, position.y, position.z, e.what());
+    }
+
+    if (!location) return push_result(Result { position, std::monostate {} });
+
+    // the completion thread only hands the bytes over, decoding them would hold up the other reads
+    m_io->queue_read(location->file, location->extent.offset, location->extent.size, [this, position](std::error_code error, std::span<std::byte const> payload) {
+        // the sectors may be rewritten as soon as they are read
+        m_storage->release(position);
+
+        if (error) {
+            SPDLOG_ERROR("failed to read chunk ({}, {}, {}): {}", position.x, position.y, position.z, error.message());
+            return push_result(Result { position, std::monostate {} });
+        }
+        (void)m_pool.submit(this, engine::components::ChunkPosition { position }, std::optional(std::vector<std::byte>(payload.begin(), payload.end())));
+    });
+
+    // the reads go out in one batch on the next poll(), there is none once the destructor started
+    bool stopping;
+    {
+        std::scoped_lock lock { m_mutex };
+        stopping = m_stopping;
+    }
+    if (stopping) m_io->submit();
+}
+
+void engine::world::ChunkStreamer::decode(engine::components::ChunkPosition const &position, std::span<std::byte const> payload)
+{
+    Result result { position, std::monostate {} };
+    try {
+        auto chunk = std::make_unique<engine::components::ChunkData>();
+        decode_chunk(payload, *chunk);
+        result.chunk = std::move(chunk);
+    } catch (engine::errors::CorruptedData const &) {
+        SPDLOG_WARN("discarding corrupted chunk ({}, {}, {}) of dimension {}", position.x, position.y, position.z, position.dimension);
+    }
+    push_result(std::move(result));
+}
+
+std::vector<engine::world::ChunkStreamer::Result> engine::world::ChunkStreamer::poll()
+{
+    m_io->submit();
+
+    std::vector<Result> results;
+    {
+        std::scoped_lock lock { m_mutex };
+        results.swap(m_finished);
+    }
+    for (auto const &result : results)
+        m_pending.erase(result.position);
+    return results;
+}
\ No newline at end of file
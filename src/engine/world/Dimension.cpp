@@ -0,0 +1,309 @@
+#include <engine/ecs/components/Body.hpp>
+#include <engine/ecs/components/Dirty.hpp>
+#include <engine/ecs/components/MappedChunkData.hpp>
+#include <engine/ecs/components/Occupancy.hpp>
+#include <engine/world/Dimension.hpp>
+#include <engine/world/chunk_blocks.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+
+bool engine::world::Dimension::is_idle() const noexcept
+{
+    return m_arrived.empty() && m_registry.view<engine::components::Body>().empty();
+}
+
+using engine::components::ColumnPosition;
+using engine::components::Heightmap;
+
+engine::world::Dimension::Dimension(std::int32_t id, engine::named_storage<engine::BlockType> const &block_types)
+    : m_id(id)
+    , m_block_types(&block_types)
+{
+    m_registry.on_construct<engine::components::ChunkPosition>().connect<&Dimension::on_chunk_construct>(*this);
+    m_registry.on_destroy<engine::components::ChunkPosition>().connect<&Dimension::on_chunk_destroy>(*this);
+}
+
+void engine::world::Dimension::on_chunk_construct(entt::registry &registry, entt::entity chunk)
+{
+    assert(&m_registry == &registry); // sanity check
+    auto const &chunk_position = registry.get<engine::components::ChunkPosition>(chunk);
+    assert(chunk_position.dimension == m_id);
+    m_chunks.emplace(chunk_position, chunk);
+}
+
+void engine::world::Dimension::on_chunk_destroy(entt::registry &registry, entt::entity chunk)
+{
+    assert(&m_registry == &registry); // sanity check
+    auto const &chunk_position = registry.get<engine::components::ChunkPosition>(chunk);
+    m_chunks.erase(chunk_position);
+
+    auto const column = m_columns.find(ColumnPosition { chunk_position.x, chunk_position.z });
+    if (column == m_columns.end()) return;
+    // the heightmaps may be gone already when the whole registry is cleared
+    auto *const heightmap = registry.try_get<Heightmap>(column->second);
+    if (!heightmap) return;
+
+    auto const it = std::ranges::lower_bound(heightmap->chunks, chunk_position.y);
+    if (it == heightmap->chunks.end() || *it != chunk_position.y) return;
+    heightmap->chunks.erase(it);
+
+    if (heightmap->chunks.empty()) {
+        registry.destroy(column->second);
+        m_columns.erase(column);
+        return;
+    }
+
+    // the tops that were in this chunk are now in one below it, if any
+    std::int32_t const bottom = chunk_position.y * chunk_size;
+    for (std::size_t kind = 0; kind < Heightmap::kind_count; ++kind) {
+        for (std::uint32_t x = 0; x < chunk_size; ++x) {
+            for (std::uint32_t z = 0; z < chunk_size; ++z) {
+                auto &height = heightmap->height(static_cast<Heightmap::Kind>(kind), x, z);
+                if (height >= bottom && height < bottom + chunk_size)
+                    height = find_height(column->first, *heightmap, static_cast<Heightmap::Kind>(kind), x, z, bottom - 1);
+            }
+        }
+    }
+}
+
+engine::components::Heightmap::Mask engine::world::Dimension::heightmap_mask(engine::Block block) const noexcept
+{
+    using Kind = Heightmap::Kind;
+    if (block.type_id == entt::null) return 0;
+
+    auto const &type = m_block_types->get(static_cast<entt::entity>(block.type_id));
+    return Heightmap::mask_of(Kind::any)
+        | (type.opaque ? Heightmap::mask_of(Kind::opaque) : 0)
+        | (type.motion_blocking ? Heightmap::mask_of(Kind::motion_blocking) : 0);
+}
+
+std::int32_t engine::world::Dimension::find_height(ColumnPosition const &column, Heightmap const &heightmap, Heightmap::Kind kind, std::uint32_t x, std::uint32_t z, std::int32_t from) const noexcept
+{
+    auto const kind_mask = Heightmap::mask_of(kind);
+    auto it = std::ranges::upper_bound(heightmap.chunks, from >> chunk_shift);
+    while (it != heightmap.chunks.begin()) {
+        --it;
+        auto const chunk = this->chunk(engine::components::ChunkPosition { column.x, *it, column.z, m_id });
+        if (chunk == entt::null || !m_registry.any_of<engine::components::ChunkData, engine::components::MappedChunkData>(chunk)) continue;
+
+        auto const blocks = chunk_blocks(m_registry, chunk);
+        std::int32_t const bottom = *it * chunk_size;
+        for (std::int32_t y = std::min(from - bottom, chunk_size - 1); y >= 0; --y)
+            if (heightmap_mask(blocks[block_index(x, y, z)]) & kind_mask)
+                return bottom + y;
+    }
+    return Heightmap::none;
+}
+
+void engine::world::Dimension::chunk_loaded(entt::entity chunk)
+{
+    auto const &chunk_position = m_registry.get<engine::components::ChunkPosition>(chunk);
+
+    auto [column, inserted] = m_columns.try_emplace(ColumnPosition { chunk_position.x, chunk_position.z }, entt::null);
+    if (inserted) {
+        column->second = m_registry.create();
+        auto &heightmap = m_registry.emplace<Heightmap>(column->second);
+        std::fill_n(&heightmap.heights[0][0], Heightmap::kind_count * chunk_size * chunk_size, Heightmap::none);
+    }
+
+    // a chunk loaded again may not have the blocks it had, its occupancy and heights are redone either way
+    auto &heightmap = m_registry.get<Heightmap>(column->second);
+    auto const it = std::ranges::lower_bound(heightmap.chunks, chunk_position.y);
+    if (it == heightmap.chunks.end() || *it != chunk_position.y)
+        heightmap.chunks.insert(it, chunk_position.y);
+
+    auto const blocks = chunk_blocks(m_registry, chunk);
+
+    auto &occupancy = m_registry.emplace_or_replace<engine::components::Occupancy>(chunk);
+    for (std::uint32_t x = 0; x < chunk_size; ++x)
+        for (std::uint32_t y = 0; y < chunk_size; ++y)
+            for (std::uint32_t z = 0; z < chunk_size; ++z)
+                if (blocks[block_index(x, y, z)].type_id != entt::null)
+                    occupancy.set(x, y, z, true);
+
+    constexpr Heightmap::Mask all_kinds = (1u << Heightmap::kind_count) - 1;
+    std::int32_t const bottom = chunk_position.y * chunk_size;
+    for (std::uint32_t x = 0; x < chunk_size; ++x) {
+        for (std::uint32_t z = 0; z < chunk_size; ++z) {
+            // going down, the first block of every kind is its top in this chunk
+            std::array<std::int32_t, Heightmap::kind_count> tops;
+            tops.fill(Heightmap::none);
+            Heightmap::Mask found = 0;
+            for (std::int32_t y = chunk_size - 1; y >= 0 && found != all_kinds; --y) {
+                auto const mask = static_cast<Heightmap::Mask>(heightmap_mask(blocks[block_index(x, y, z)]) & ~found);
+                if (!mask) continue;
+                found |= mask;
+                for (std::size_t kind = 0; kind < Heightmap::kind_count; ++kind)
+                    if (mask & Heightmap::mask_of(static_cast<Heightmap::Kind>(kind))) tops[kind] = bottom + y;
+            }
+
+            for (std::size_t i = 0; i < Heightmap::kind_count; ++i) {
+                auto const kind = static_cast<Heightmap::Kind>(i);
+                auto &height = heightmap.height(kind, x, z);
+                // a chunk above has the top already
+                if (height >= bottom + chunk_size) continue;
+                if (tops[i] != Heightmap::none)
+                    height = tops[i];
+                else if (height >= bottom)
+                    height = find_height(column->first, heightmap, kind, x, z, bottom - 1);
+            }
+        }
+    }
+}
+
+std::int32_t engine::world::Dimension::height(Heightmap::Kind kind, std::int32_t x, std::int32_t z) const noexcept
+{
+    auto const column = this->column(ColumnPosition { x >> chunk_shift, z >> chunk_shift });
+    if (column == entt::null) return Heightmap::none;
+    return m_registry.get<Heightmap>(column).height(kind, x & (chunk_size - 1), z & (chunk_size - 1));
+}
+
+engine::Block const *engine::world::Dimension::block(glm::ivec3 position) const noexcept
+{
+    auto const chunk = this->chunk(chunk_of(position, m_id));
+    if (chunk == entt::null) return nullptr;
+
+    auto const local = local_of(position);
+    return &chunk_blocks(m_registry, chunk)[block_index(local.x, local.y, local.z)];
+}
+
+bool engine::world::Dimension::set_block(glm::ivec3 position, engine::Block block, entt::id_type payload)
+{
+    auto const chunk_position = chunk_of(position, m_id);
+    auto const chunk = this->chunk(chunk_position);
+    if (chunk == entt::null) return false;
+
+    auto const local = local_of(position);
+    auto const index = block_index(local.x, local.y, local.z);
+    auto &chunk_data = writable_chunk(m_registry, chunk);
+    auto &slot = chunk_data.blocks[index];
+    auto const old_mask = heightmap_mask(slot);
+    auto const new_mask = heightmap_mask(block);
+    slot = block;
+    chunk_data.payloads.set(index, payload);
+
+    if (auto *const occupancy = m_registry.try_get<engine::components::Occupancy>(chunk))
+        occupancy->set(local.x, local.y, local.z, block.type_id != entt::null);
+
+    m_registry.emplace_or_replace<engine::components::Dirty>(chunk);
+    // the neighbour's faces against it may have changed too
+    for (int axis = 0; axis < 3; ++axis) {
+        if (local[axis] != 0 && local[axis] != chunk_size - 1) continue;
+        auto neighbour_position = chunk_position;
+        auto &coordinate = axis == 0 ? neighbour_position.x : axis == 1 ? neighbour_position.y : neighbour_position.z;
+        coordinate += local[axis] == 0 ? -1 : 1;
+        if (auto const neighbour = this->chunk(neighbour_position); neighbour != entt::null)
+            m_registry.emplace_or_replace<engine::components::Dirty>(neighbour);
+    }
+
+    if (old_mask == new_mask) return true;
+
+    auto const column = m_columns.find(ColumnPosition { chunk_position.x, chunk_position.z });
+    if (column == m_columns.end()) return true;
+
+    auto &heightmap = m_registry.get<Heightmap>(column->second);
+    for (std::size_t i = 0; i < Heightmap::kind_count; ++i) {
+        auto const kind = static_cast<Heightmap::Kind>(i);
+        auto &height = heightmap.height(kind, local.x, local.z);
+        if (new_mask & Heightmap::mask_of(kind))
+            height = std::max(height, position.y);
+        else if (height == position.y)
+            height = find_height(column->first, heightmap, kind, local.x, local.z, position.y - 1);
+    }
+    return true;
+}
+
+std::optional<engine::world::RaycastHit> engine::world::Dimension::raycast(glm::vec3 origin, glm::vec3 direction, float max_distance) const noexcept
+{
+    using engine::components::Occupancy;
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+
+    if (glm::length(direction) == 0.0f) return std::nullopt;
+    direction = glm::normalize(direction);
+    origin += grid_offset;
+
+    glm::ivec3 const step = glm::ivec3 { glm::sign(direction) };
+    glm::ivec3 voxel = glm::ivec3 { glm::floor(origin) };
+
+    // distance along the ray to the next boundary of a cell of the given size, on every axis
+    auto const boundaries = [&](glm::ivec3 cell_min, std::int32_t size) {
+        glm::vec3 result;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (step[axis] == 0)
+                result[axis] = infinity;
+            else
+                result[axis] = (static_cast<float>(step[axis] > 0 ? cell_min[axis] + size : cell_min[axis]) - origin[axis]) / direction[axis];
+        }
+        return result;
+    };
+
+    glm::vec3 const t_delta = glm::abs(1.0f / direction);
+    glm::vec3 t_max = boundaries(voxel, 1);
+    float t = 0.0f;
+    int entered_axis = -1;
+
+    engine::components::ChunkPosition cached_position = chunk_of(voxel, m_id);
+    Occupancy const *occupancy = nullptr;
+    entt::entity cached_chunk = entt::null;
+    auto const lookup = [&](engine::components::ChunkPosition const &position) {
+        cached_position = position;
+        cached_chunk = chunk(position);
+        occupancy = cached_chunk == entt::null ? nullptr : m_registry.try_get<Occupancy>(cached_chunk);
+    };
+    lookup(cached_position);
+
+    while (t <= max_distance) {
+        if (auto const position = chunk_of(voxel, m_id); position != cached_position)
+            lookup(position);
+
+        std::int32_t skip = chunk_size;
+        if (occupancy && occupancy->bricks) {
+            auto const local = local_of(voxel);
+            if (!(occupancy->bricks >> Occupancy::brick_of(local.x, local.y, local.z) & 1u)) {
+                skip = Occupancy::brick_size;
+            } else if (occupancy->test(local.x, local.y, local.z)) {
+                constexpr engine::Sides entered_through[3][2] = {
+                    { engine::Sides::EAST, engine::Sides::WEST },
+                    { engine::Sides::TOP, engine::Sides::BOTTOM },
+                    { engine::Sides::SOUTH, engine::Sides::NORTH },
+                };
+                return RaycastHit {
+                    .position = voxel,
+                    .block = chunk_blocks(m_registry, cached_chunk)[block_index(local.x, local.y, local.z)],
+                    .face = entered_axis < 0 ? engine::Sides::NONE : entered_through[entered_axis][step[entered_axis] > 0],
+                    .distance = t,
+                };
+            } else {
+                skip = 1;
+            }
+        }
+
+        if (skip == 1) {
+            entered_axis = t_max.x < t_max.y ? (t_max.x < t_max.z ? 0 : 2) : (t_max.y < t_max.z ? 1 : 2);
+            t = t_max[entered_axis];
+            voxel[entered_axis] += step[entered_axis];
+            t_max[entered_axis] += t_delta[entered_axis];
+            continue;
+        }
+
+        // leave the whole empty cell in one go
+        glm::ivec3 const cell_min = voxel & -skip;
+        glm::vec3 const exits = boundaries(cell_min, skip);
+        entered_axis = exits.x < exits.y ? (exits.x < exits.z ? 0 : 2) : (exits.y < exits.z ? 1 : 2);
+        t = exits[entered_axis];
+        for (int axis = 0; axis < 3; ++axis) {
+            if (axis == entered_axis)
+                voxel[axis] = step[axis] > 0 ? cell_min[axis] + skip : cell_min[axis] - 1;
+            else // clamped so rounding can't put it outside the cell
+                voxel[axis] = std::clamp(static_cast<std::int32_t>(std::floor(origin[axis] + direction[axis] * t)), cell_min[axis], cell_min[axis] + skip - 1);
+        }
+        t_max = boundaries(voxel, 1);
+    }
+    return std::nullopt;
+}
\ No newline at end of file
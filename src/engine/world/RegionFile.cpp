@@ -0,0 +1,249 @@
+#include <engine/errors/CorruptedData.hpp>
+#include <engine/system/block_size.hpp>
+#include <engine/system/positioned_io.hpp>
+#include <engine/world/RegionFile.hpp>
+#include <utils/endian.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace {
+    constexpr std::byte magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'R' }, std::byte { 'F' } };
+    constexpr std::uint32_t version = 1;
+
+    // magic, version, sector size, chunk count
+    constexpr std::size_t prologue_size = 16;
+    constexpr std::size_t entry_size = 2 * sizeof(std::uint32_t);
+    constexpr std::size_t header_size = prologue_size + engine::world::RegionFile::chunk_count * entry_size;
+}
+
+static std::size_t pick_sector_size(std::FILE *fp) noexcept
+{
+    using engine::world::RegionFile;
+
+    try {
+        auto const block_size = engine::system::block_size(fp);
+        if (RegionFile::valid_sector_size(block_size))
+            return block_size;
+        SPDLOG_WARN("unusable filesystem block size {}, using {}", block_size, RegionFile::default_sector_size);
+    } catch (std::system_error const &e) {
+        SPDLOG_WARN("failed to query the filesystem block size ({}), using {}", e.what(), RegionFile::default_sector_size);
+    }
+    return RegionFile::default_sector_size;
+}
+
+engine::world::RegionPosition engine::world::RegionFile::region_of(engine::components::ChunkPosition const &position) noexcept
+{
+    // arithmetic shifts floor towards negative infinity, which is what we want for negative coordinates
+    return RegionPosition {
+        .x = position.x >> std::countr_zero(static_cast<std::uint32_t>(width)),
+        .y = position.y >> std::countr_zero(static_cast<std::uint32_t>(height)),
+        .z = position.z >> std::countr_zero(static_cast<std::uint32_t>(width)),
+        .dimension = position.dimension,
+    };
+}
+
+std::size_t engine::world::RegionFile::index_of(engine::components::ChunkPosition const &position) noexcept
+{
+    auto const x = static_cast<std::size_t>(position.x & (width - 1));
+    auto const y = static_cast<std::size_t>(position.y & (height - 1));
+    auto const z = static_cast<std::size_t>(position.z & (width - 1));
+    return (x * height + y) * width + z;
+}
+
+engine::world::RegionFile::RegionFile(engine::File file, std::size_t sector_size) noexcept
+    : m_file(std::move(file))
+    , m_sector_size(sector_size)
+    , m_entries(chunk_count, Entry { 0, 0 })
+{
+}
+
+engine::world::RegionFile engine::world::RegionFile::open(std::filesystem::path const &path)
+{
+    std::error_code ec;
+    auto const file_size = std::filesystem::file_size(path, ec);
+    bool const exists = !ec && file_size != 0;
+
+    auto file = engine::File::open(path, exists ? "r+b" : "w+b");
+
+    if (!exists) {
+        auto const sector_size = pick_sector_size(file.get());
+        RegionFile region(std::move(file), sector_size);
+        auto const header_sectors = region.sectors_for(header_size);
+
+        std::vector<std::byte> header(header_sectors * region.m_sector_size);
+        std::memcpy(header.data(), magic, sizeof(magic));
+        utils::store_le(header.data() + 4, version);
+        utils::store_le(header.data() + 8, static_cast<std::uint32_t>(region.m_sector_size));
+        utils::store_le(header.data() + 12, static_cast<std::uint32_t>(chunk_count));
+        engine::system::write_at(region.m_file.get(), 0, header);
+
+        region.m_used_sectors.assign(header_sectors, true);
+        return region;
+    }
+
+    std::byte prologue[prologue_size];
+    if (engine::system::read_at(file.get(), 0, prologue) != prologue_size || std::memcmp(prologue, magic, sizeof(magic)) != 0) {
+        SPDLOG_ERROR("{} is not a region file", path.generic_string());
+        throw engine::errors::CorruptedData();
+    }
+
+    auto const file_version = utils::load_le<std::uint32_t>(prologue + 4);
+    auto const sector_size = utils::load_le<std::uint32_t>(prologue + 8);
+    auto const file_chunk_count = utils::load_le<std::uint32_t>(prologue + 12);
+    if (file_version != version || !valid_sector_size(sector_size) || file_chunk_count != chunk_count) {
+        SPDLOG_ERROR("{} has an unsupported header (version {}, sector size {}, {} chunks)", path.generic_string(), file_version, sector_size, file_chunk_count);
+        throw engine::errors::CorruptedData();
+    }
+
+    RegionFile region(std::move(file), sector_size);
+    auto const header_sectors = region.sectors_for(header_size);
+    auto const file_sectors = std::max(header_sectors, region.sectors_for(file_size));
+
+    std::vector<std::byte> table(chunk_count * entry_size);
+    if (engine::system::read_at(region.m_file.get(), prologue_size, table) != table.size()) {
+        SPDLOG_ERROR("{} has a truncated offset table", path.generic_string());
+        throw engine::errors::CorruptedData();
+    }
+
+    region.m_used_sectors.assign(file_sectors, false);
+    region.mark_used(0, header_sectors);
+
+    for (std::size_t i = 0; i < chunk_count; ++i) {
+        Entry const entry {
+            .sector = utils::load_le<std::uint32_t>(table.data() + i * entry_size),
+            .size = utils::load_le<std::uint32_t>(table.data() + i * entry_size + sizeof(std::uint32_t)),
+        };
+        if (entry.size == 0) continue;
+
+        auto const sectors = region.sectors_for(entry.size);
+        if (entry.sector < header_sectors || entry.sector + sectors > file_sectors) {
+            SPDLOG_ERROR("{}: chunk {} points outside of the file (sector {}, {} bytes)", path.generic_string(), i, entry.sector, entry.size);
+            throw engine::errors::CorruptedData();
+        }
+        if (std::any_of(region.m_used_sectors.begin() + entry.sector, region.m_used_sectors.begin() + entry.sector + sectors, std::identity {})) {
+            SPDLOG_ERROR("{}: chunk {} overlaps another chunk", path.generic_string(), i);
+            throw engine::errors::CorruptedData();
+        }
+
+        region.m_entries[i] = entry;
+        region.mark_used(entry.sector, sectors);
+    }
+
+    return region;
+}
+
+std::optional<std::vector<std::byte>> engine::world::RegionFile::read(std::size_t index) const
+{
+    auto const entry = m_entries[index];
+    if (entry.size == 0) return std::nullopt;
+
+    std::vector<std::byte> payload(entry.size);
+    if (engine::system::read_at(m_file.get(), std::uint64_t { entry.sector } * m_sector_size, payload) != payload.size()) {
+        SPDLOG_ERROR("chunk {} payload is truncated", index);
+        throw engine::errors::CorruptedData();
+    }
+    return payload;
+}
+
+std::optional<engine::world::RegionFile::MappedPayload> engine::world::RegionFile::map(std::size_t index)
+{
+    auto const entry = m_entries[index];
+    if (entry.size == 0) return std::nullopt;
+
+    auto const begin = std::size_t { entry.sector } * m_sector_size;
+    if (!m_mapping || begin + entry.size > m_mapping->get_size())
+        m_mapping = std::make_shared<boost::interprocess::mapped_region const>(engine::map_to_memory(m_file.get()));
+
+    if (begin + entry.size > m_mapping->get_size()) {
+        SPDLOG_ERROR("chunk {} payload is truncated", index);
+        throw engine::errors::CorruptedData();
+    }
+
+    auto const *const base = static_cast<std::byte const *>(m_mapping->get_address());
+    return MappedPayload { m_mapping, std::span(base + begin, entry.size) };
+}
+
+void engine::world::RegionFile::write(std::size_t index, std::span<std::byte const> payload)
+{
+    if (payload.empty()) return erase(index);
+
+    auto const old_entry = m_entries[index];
+    auto const old_sectors = sectors_for(old_entry.size);
+    auto const new_sectors = sectors_for(payload.size());
+
+    // pad to whole sectors so no write ends in the middle of a filesystem block
+    std::vector<std::byte> buffer(new_sectors * m_sector_size);
+    std::ranges::copy(payload, buffer.begin());
+
+    if (old_entry.size != 0 && new_sectors <= old_sectors) {
+        engine::system::write_at(m_file.get(), std::uint64_t { old_entry.sector } * m_sector_size, buffer);
+        write_entry(index, Entry { old_entry.sector, static_cast<std::uint32_t>(payload.size()) });
+        release(old_entry.sector + new_sectors, old_sectors - new_sectors);
+        return;
+    }
+
+    // the payload is written before the table entry pointing at it,
+    // so the previous version stays readable if we are interrupted
+    auto const sector = allocate(new_sectors);
+    engine::system::write_at(m_file.get(), std::uint64_t { sector } * m_sector_size, buffer);
+    write_entry(index, Entry { sector, static_cast<std::uint32_t>(payload.size()) });
+    if (old_entry.size != 0)
+        release(old_entry.sector, old_sectors);
+}
+
+void engine::world::RegionFile::erase(std::size_t index)
+{
+    auto const entry = m_entries[index];
+    if (entry.size == 0) return;
+
+    write_entry(index, Entry { 0, 0 });
+    release(entry.sector, sectors_for(entry.size));
+}
+
+void engine::world::RegionFile::flush()
+{
+    engine::system::sync(m_file.get());
+}
+
+std::uint32_t engine::world::RegionFile::allocate(std::size_t sectors)
+{
+    // first fit, a trailing free run is extended instead of skipped
+    std::size_t run_start = 0, run_length = 0;
+    for (std::size_t i = 0; i < m_used_sectors.size(); ++i) {
+        if (m_used_sectors[i]) {
+            run_length = 0;
+            continue;
+        }
+        if (run_length++ == 0) run_start = i;
+        if (run_length == sectors) break;
+    }
+    if (run_length == 0) run_start = m_used_sectors.size();
+
+    if (run_start + sectors > m_used_sectors.size())
+        m_used_sectors.resize(run_start + sectors, false);
+    mark_used(static_cast<std::uint32_t>(run_start), sectors);
+    return static_cast<std::uint32_t>(run_start);
+}
+
+void engine::world::RegionFile::release(std::uint32_t first, std::size_t sectors) noexcept
+{
+    std::fill_n(m_used_sectors.begin() + first, sectors, false);
+}
+
+void engine::world::RegionFile::mark_used(std::uint32_t first, std::size_t sectors) noexcept
+{
+    std::fill_n(m_used_sectors.begin() + first, sectors, true);
+}
+
+void engine::world::RegionFile::write_entry(std::size_t index, Entry entry)
+{
+    std::byte bytes[entry_size];
+    utils::store_le(bytes, entry.sector);
+    utils::store_le(bytes + sizeof(std::uint32_t), entry.size);
+    engine::system::write_at(m_file.get(), prologue_size + index * entry_size, bytes);
+    m_entries[index] = entry;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <engine/world/RegionStorage.hpp>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+engine::world::RegionStorage::RegionStorage(std::filesystem::path directory, Compression compression)
+    : m_directory(std::move(directory))
+    , m_compression(compression)
+{
+}
+
+std::filesystem::path engine::world::RegionStorage::region_path(RegionPosition const &position) const
+{
+    return m_directory / fmt::format("dim{}", position.dimension) / fmt::format("r.{}.{}.{}.region", position.x, position.y, position.z);
+}
+
+engine::world::RegionFile *engine::world::RegionStorage::find_region(RegionPosition const &position)
+{
+    if (auto it = m_regions.find(position); it != m_regions.end())
+        return &it->second;
+
+    auto const path = region_path(position);
+    if (!std::filesystem::exists(path))
+        return nullptr;
+
+    return &m_regions.emplace(position, RegionFile::open(path)).first->second;
+}
+
+engine::world::RegionFile &engine::world::RegionStorage::region(RegionPosition const &position)
+{
+    if (auto it = m_regions.find(position); it != m_regions.end())
+        return it->second;
+
+    auto const path = region_path(position);
+    std::filesystem::create_directories(path.parent_path());
+    SPDLOG_DEBUG("opening region {}", path.generic_string());
+    return m_regions.emplace(position, RegionFile::open(path)).first->second;
+}
+
+void engine::world::RegionStorage::save(engine::components::ChunkPosition const &position, engine::components::ChunkData const &chunk)
+{
+    save_payload(position, encode_chunk(chunk, m_compression));
+}
+
+void engine::world::RegionStorage::save_payload(engine::components::ChunkPosition const &position, std::span<std::byte const> payload)
+{
+    std::unique_lock lock { m_mutex };
+    m_unpinned.wait(lock, [&] { return !m_pinned.contains(position); });
+    region(RegionFile::region_of(position)).write(RegionFile::index_of(position), payload);
+}
+
+bool engine::world::RegionStorage::load(engine::components::ChunkPosition const &position, engine::components::ChunkData &chunk)
+{
+    std::scoped_lock lock { m_mutex };
+
+    auto *const region = find_region(RegionFile::region_of(position));
+    if (!region) return false;
+
+    auto const payload = region->read(RegionFile::index_of(position));
+    if (!payload) return false;
+
+    decode_chunk(*payload, chunk);
+    return true;
+}
+
+std::optional<engine::components::MappedChunkData> engine::world::RegionStorage::map(engine::components::ChunkPosition const &position)
+{
+    std::scoped_lock lock { m_mutex };
+
+    auto *const region = find_region(RegionFile::region_of(position));
+    if (!region) return std::nullopt;
+
+    auto payload = region->map(RegionFile::index_of(position));
+    if (!payload) return std::nullopt;
+
+    engine::BlockPayloads payloads;
+    auto const *const blocks = view_chunk(payload->bytes, payloads);
+    if (!blocks) return std::nullopt;
+
+    return engine::components::MappedChunkData { std::move(payload->mapping), blocks, std::move(payloads) };
+}
+
+std::optional<engine::world::RegionStorage::Location> engine::world::RegionStorage::locate(engine::components::ChunkPosition const &position)
+{
+    std::scoped_lock lock { m_mutex };
+
+    auto *const region = find_region(RegionFile::region_of(position));
+    if (!region) return std::nullopt;
+
+    auto const extent = region->locate(RegionFile::index_of(position));
+    if (!extent) return std::nullopt;
+
+    ++m_pinned[position];
+    return Location { region->file(), *extent };
+}
+
+void engine::world::RegionStorage::release(engine::components::ChunkPosition const &position)
+{
+    {
+        std::scoped_lock lock { m_mutex };
+        auto const it = m_pinned.find(position);
+        if (it == m_pinned.end() || --it->second != 0) return;
+        m_pinned.erase(it);
+    }
+    m_unpinned.notify_all();
+}
+
+void engine::world::RegionStorage::erase(engine::components::ChunkPosition const &position)
+{
+    std::unique_lock lock { m_mutex };
+    m_unpinned.wait(lock, [&] { return !m_pinned.contains(position); });
+
+    if (auto *const region = find_region(RegionFile::region_of(position)))
+        region->erase(RegionFile::index_of(position));
+}
+
+void engine::world::RegionStorage::flush()
+{
+    std::scoped_lock lock { m_mutex };
+    for (auto &[position, region] : m_regions)
+        region.flush();
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <engine/ecs/components/Modified.hpp>
+#include <engine/system/block_size.hpp>
+#include <engine/system/positioned_io.hpp>
+#include <engine/world/ChunkCodec.hpp>
+#include <engine/world/WorldSaver.hpp>
+#include <utils/endian.hpp>
+#include <utils/hash.hpp>
+
+#include <entt/entity/registry.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <unordered_set>
+
+namespace {
+    constexpr std::byte journal_magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'J' }, std::byte { 'R' } };
+    constexpr std::byte commit_magic[4] = { std::byte { 'L' }, std::byte { 'G' }, std::byte { 'J' }, std::byte { 'C' } };
+    constexpr std::uint32_t version = 1;
+
+    // magic, version, sequence, entry count, body size, body checksum
+    constexpr std::size_t header_size = 32;
+    // magic, padding, sequence, body checksum
+    constexpr std::size_t commit_size = 24;
+    // chunk position, payload size
+    constexpr std::size_t entry_header_size = 4 * sizeof(std::int32_t) + sizeof(std::uint32_t);
+}
+
+engine::world::WorldSaver::WorldSaver(RegionStorage &storage)
+    : m_storage(&storage)
+{
+    auto const path = storage.directory() / "journal";
+    std::filesystem::create_directories(storage.directory());
+    m_journal = engine::File::open(path, std::filesystem::exists(path) ? "r+b" : "w+b");
+
+    // the same blocks the regions use for their sectors
+    m_block_size = RegionFile::default_sector_size;
+    try {
+        auto const block_size = engine::system::block_size(m_journal.get());
+        if (RegionFile::valid_sector_size(block_size))
+            m_block_size = block_size;
+    } catch (std::system_error const &) {
+    }
+
+    replay();
+    m_thread = std::thread(&WorldSaver::thread_main, this);
+}
+
+engine::world::WorldSaver::~WorldSaver()
+{
+    {
+        std::scoped_lock lock { m_mutex };
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+std::size_t engine::world::WorldSaver::save_modified(entt::registry &registry)
+{
+    Batch batch;
+    registry.view<engine::components::ChunkPosition, engine::components::ChunkData, engine::components::Modified>().each([&](auto const &position, auto const &chunk_data) {
+        batch.emplace_back(position, std::make_unique<engine::components::ChunkData>(chunk_data));
+    });
+    registry.clear<engine::components::Modified>();
+
+    auto const count = batch.size();
+    if (count == 0) return 0;
+
+    {
+        std::scoped_lock lock { m_mutex };
+        m_batches.push_back(std::move(batch));
+    }
+    m_cv.notify_all();
+    return count;
+}
+
+void engine::world::WorldSaver::wait_idle()
+{
+    std::unique_lock lock { m_mutex };
+    m_cv.wait(lock, [this] { return m_batches.empty() && !m_writing; });
+}
+
+void engine::world::WorldSaver::thread_main()
+{
+    for (;;) {
+        std::deque<Batch> batches;
+        {
+            std::unique_lock lock { m_mutex };
+            m_cv.wait(lock, [this] { return m_stopping || !m_batches.empty(); });
+            if (m_batches.empty()) return;
+            batches.swap(m_batches);
+            m_writing = true;
+        }
+
+        // everything queued goes in one journal, the newest copy of a chunk wins
+        Batch merged;
+        std::unordered_set<engine::components::ChunkPosition> seen;
+        for (auto batch = batches.rbegin(); batch != batches.rend(); ++batch)
+            for (auto &chunk : *batch)
+                if (seen.insert(chunk.first).second)
+                    merged.push_back(std::move(chunk));
+
+        try {
+            write(merged);
+        } catch (std::exception const &e) {
+            SPDLOG_ERROR("failed to save {} chunks: {}", merged.size(), e.what());
+        }
+
+        {
+            std::scoped_lock lock { m_mutex };
+            m_writing = false;
+        }
+        m_cv.notify_all();
+    }
+}
+
+void engine::world::WorldSaver::write(Batch const &batch)
+{
+    std::vector<std::vector<std::byte>> payloads;
+    payloads.reserve(batch.size());
+    for (auto const &[position, chunk_data] : batch)
+        payloads.push_back(encode_chunk(*chunk_data, m_storage->compression()));
+
+    std::vector<std::byte> journal(header_size);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        auto const &position = batch[i].first;
+        auto const offset = journal.size();
+        journal.resize(offset + entry_header_size);
+        utils::store_le(journal.data() + offset + 0, position.x);
+        utils::store_le(journal.data() + offset + 4, position.y);
+        utils::store_le(journal.data() + offset + 8, position.z);
+        utils::store_le(journal.data() + offset + 12, position.dimension);
+        utils::store_le(journal.data() + offset + 16, static_cast<std::uint32_t>(payloads[i].size()));
+        journal.insert(journal.end(), payloads[i].begin(), payloads[i].end());
+    }
+
+    auto const body_size = journal.size() - header_size;
+    auto const checksum = utils::fnv1a(std::span(journal).subspan(header_size));
+    auto const sequence = ++m_sequence;
+
+    std::memcpy(journal.data(), journal_magic, sizeof(journal_magic));
+    utils::store_le(journal.data() + 4, version);
+    utils::store_le(journal.data() + 8, sequence);
+    utils::store_le(journal.data() + 16, static_cast<std::uint32_t>(batch.size()));
+    utils::store_le(journal.data() + 20, static_cast<std::uint32_t>(body_size));
+    utils::store_le(journal.data() + 24, checksum);
+    journal.resize(align(journal.size()));
+
+    std::vector<std::byte> commit(align(commit_size));
+    std::memcpy(commit.data(), commit_magic, sizeof(commit_magic));
+    utils::store_le(commit.data() + 8, sequence);
+    utils::store_le(commit.data() + 16, checksum);
+
+    // the commit record only reaches the disk after the whole journal did
+    engine::system::write_at(m_journal.get(), 0, journal);
+    engine::system::sync(m_journal.get());
+    engine::system::write_at(m_journal.get(), journal.size(), commit);
+    engine::system::sync(m_journal.get());
+
+    for (std::size_t i = 0; i < batch.size(); ++i)
+        m_storage->save_payload(batch[i].first, payloads[i]);
+    m_storage->flush();
+
+    retire_journal();
+    SPDLOG_DEBUG("saved {} chunks", batch.size());
+}
+
+void engine::world::WorldSaver::replay()
+{
+    std::byte header[header_size];
+    if (engine::system::read_at(m_journal.get(), 0, header) != header_size || std::memcmp(header, journal_magic, sizeof(journal_magic)) != 0)
+        return;
+
+    auto const file_version = utils::load_le<std::uint32_t>(header + 4);
+    auto const sequence = utils::load_le<std::uint64_t>(header + 8);
+    auto const entry_count = utils::load_le<std::uint32_t>(header + 16);
+    auto const body_size = utils::load_le<std::uint32_t>(header + 20);
+    auto const checksum = utils::load_le<std::uint64_t>(header + 24);
+    m_sequence = sequence;
+
+    std::vector<std::byte> body(body_size);
+    std::byte commit[commit_size];
+    bool const committed = file_version == version
+        && engine::system::read_at(m_journal.get(), header_size, body) == body.size()
+        && utils::fnv1a(body) == checksum
+        && engine::system::read_at(m_journal.get(), align(header_size + body_size), commit) == commit_size
+        && std::memcmp(commit, commit_magic, sizeof(commit_magic)) == 0
+        && utils::load_le<std::uint64_t>(commit + 8) == sequence
+        && utils::load_le<std::uint64_t>(commit + 16) == checksum;
+
+    if (!committed) {
+        // the previous save died before its commit, the region files were never touched
+        SPDLOG_WARN("discarding an uncommitted save journal");
+        return retire_journal();
+    }
+
+    std::size_t offset = 0;
+    for (std::uint32_t i = 0; i < entry_count; ++i) {
+        if (offset + entry_header_size > body.size()) break;
+        engine::components::ChunkPosition const position {
+            .x = utils::load_le<std::int32_t>(body.data() + offset + 0),
+            .y = utils::load_le<std::int32_t>(body.data() + offset + 4),
+            .z = utils::load_le<std::int32_t>(body.data() + offset + 8),
+            .dimension = utils::load_le<std::int32_t>(body.data() + offset + 12),
+        };
+        auto const payload_size = utils::load_le<std::uint32_t>(body.data() + offset + 16);
+        offset += entry_header_size;
+        if (offset + payload_size > body.size()) break;
+
+        m_storage->save_payload(position, std::span(body).subspan(offset, payload_size));
+        offset += payload_size;
+    }
+    m_storage->flush();
+
+    SPDLOG_INFO("recovered {} chunks from an interrupted save", entry_count);
+    retire_journal();
+}
+
+void engine::world::WorldSaver::retire_journal()
+{
+    std::vector<std::byte> empty(m_block_size);
+    engine::system::write_at(m_journal.get(), 0, empty);
+    engine::system::sync(m_journal.get());
+}
\ No newline at end of file
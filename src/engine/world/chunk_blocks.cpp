@@ -0,0 +1,39 @@
+#include <engine/ecs/components/MappedChunkData.hpp>
+#include <engine/ecs/components/Modified.hpp>
+#include <engine/world/chunk_blocks.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <algorithm>
+
+engine::world::ChunkBlocks engine::world::chunk_blocks(entt::registry const &registry, entt::entity chunk)
+{
+    if (auto const *chunk_data = registry.try_get<engine::components::ChunkData>(chunk))
+        return ChunkBlocks(chunk_data->blocks);
+
+    auto const &mapped = registry.get<engine::components::MappedChunkData>(chunk);
+    return ChunkBlocks(mapped.blocks, engine::components::ChunkData::block_count);
+}
+
+engine::BlockPayloads const &engine::world::chunk_payloads(entt::registry const &registry, entt::entity chunk)
+{
+    if (auto const *chunk_data = registry.try_get<engine::components::ChunkData>(chunk))
+        return chunk_data->payloads;
+
+    return registry.get<engine::components::MappedChunkData>(chunk).payloads;
+}
+
+engine::components::ChunkData &engine::world::writable_chunk(entt::registry &registry, entt::entity chunk)
+{
+    registry.emplace_or_replace<engine::components::Modified>(chunk);
+
+    if (auto *chunk_data = registry.try_get<engine::components::ChunkData>(chunk))
+        return *chunk_data;
+
+    auto const &mapped = registry.get<engine::components::MappedChunkData>(chunk);
+    auto &chunk_data = registry.emplace<engine::components::ChunkData>(chunk);
+    std::copy_n(mapped.blocks, engine::components::ChunkData::block_count, chunk_data.blocks);
+    chunk_data.payloads = mapped.payloads;
+    registry.remove<engine::components::MappedChunkData>(chunk);
+    return chunk_data;
+}
\ No newline at end of file
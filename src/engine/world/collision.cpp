@@ -0,0 +1,233 @@
+#include <engine/ecs/components/Body.hpp>
+#include <engine/ecs/components/Occupancy.hpp>
+#include <engine/world/Dimension.hpp>
+#include <engine/world/chunk_blocks.hpp>
+#include <engine/world/collision.hpp>
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+using engine::world::Box;
+
+namespace {
+    // keeps bodies from ending up a rounding error inside what they touch
+    constexpr float skin = 1.0f / 1024.0f;
+    // how far below a body the ground can be for it to stand on it
+    constexpr float ground_probe = 1e-3f;
+}
+
+engine::world::CollisionShapes::CollisionShapes(engine::named_storage<engine::BlockType> const &block_types, entt::storage<engine::assets::BlockMesh> const &block_meshes)
+{
+    m_shapes.resize(block_types.size());
+    block_types.each([&](entt::entity id, engine::BlockType const &type) {
+        if (!type.motion_blocking || type.mesh_id == entt::null) return;
+        if (!block_meshes.contains(static_cast<entt::entity>(type.mesh_id))) return;
+
+        auto const *mesh = block_meshes.get(static_cast<entt::entity>(type.mesh_id)).get_solid_mesh(engine::Sides::ALL);
+        if (!mesh || mesh->vertices.empty()) return;
+
+        Box box { glm::vec3 { std::numeric_limits<float>::max() }, glm::vec3 { std::numeric_limits<float>::lowest() } };
+        for (auto const &vertex : mesh->vertices) {
+            box.min = glm::min(box.min, vertex.position);
+            box.max = glm::max(box.max, vertex.position);
+        }
+        // models are centred on the block
+        box.min += grid_offset;
+        box.max += grid_offset;
+
+        auto const index = static_cast<std::size_t>(entt::to_integral(id));
+        if (index >= m_shapes.size()) m_shapes.resize(index + 1);
+        m_shapes[index] = box;
+    });
+}
+
+namespace {
+    /**
+     * boxes of the blocks of the bricks bodies touch during a tick
+     * a brick is gathered whole the first time a body gets near it, the bodies around it reuse its boxes
+     */
+    class BoxCache {
+    public:
+        BoxCache(engine::world::Dimension const &dimension, engine::world::CollisionShapes const &shapes) noexcept
+            : m_dimension(&dimension)
+            , m_shapes(&shapes)
+        {
+        }
+
+        // appends the boxes of every brick a region touches
+        void gather(Box const &region, std::vector<Box> &boxes);
+
+    private:
+        using Occupancy = engine::components::Occupancy;
+
+        struct Chunk {
+            entt::entity entity = entt::null;
+            Occupancy const *occupancy = nullptr;
+            // where the boxes of each brick are in m_boxes, once gathered
+            std::array<std::optional<std::pair<std::uint32_t, std::uint32_t>>, 64> bricks;
+        };
+
+        Chunk &chunk(engine::components::ChunkPosition const &);
+        std::pair<std::uint32_t, std::uint32_t> gather_brick(Chunk const &, glm::ivec3 origin, std::size_t brick);
+
+        engine::world::Dimension const *m_dimension;
+        engine::world::CollisionShapes const *m_shapes;
+        std::unordered_map<engine::components::ChunkPosition, Chunk> m_chunks;
+        std::vector<Box> m_boxes;
+    };
+} // namespace
+
+BoxCache::Chunk &BoxCache::chunk(engine::components::ChunkPosition const &position)
+{
+    auto const [it, inserted] = m_chunks.try_emplace(position);
+    if (inserted) {
+        it->second.entity = m_dimension->chunk(position);
+        if (it->second.entity != entt::null)
+            it->second.occupancy = m_dimension->registry().try_get<Occupancy>(it->second.entity);
+    }
+    return it->second;
+}
+
+std::pair<std::uint32_t, std::uint32_t> BoxCache::gather_brick(Chunk const &chunk, glm::ivec3 origin, std::size_t brick)
+{
+    constexpr std::int32_t brick_size = Occupancy::brick_size;
+    constexpr std::int32_t bricks_per_axis = Occupancy::bricks_per_axis;
+    glm::ivec3 const first = glm::ivec3 {
+        static_cast<std::int32_t>(brick) / (bricks_per_axis * bricks_per_axis),
+        static_cast<std::int32_t>(brick) / bricks_per_axis % bricks_per_axis,
+        static_cast<std::int32_t>(brick) % bricks_per_axis,
+    } * brick_size;
+
+    auto const blocks = engine::world::chunk_blocks(m_dimension->registry(), chunk.entity);
+    auto const begin = static_cast<std::uint32_t>(m_boxes.size());
+    for (std::int32_t x = first.x; x < first.x + brick_size; ++x) {
+        for (std::int32_t y = first.y; y < first.y + brick_size; ++y) {
+            for (std::int32_t z = first.z; z < first.z + brick_size; ++z) {
+                if (!chunk.occupancy->test(x, y, z)) continue;
+                auto const *const shape = m_shapes->shape(blocks[engine::world::block_index(x, y, z)].type_id);
+                if (!shape) continue;
+                glm::vec3 const offset { origin + glm::ivec3 { x, y, z } };
+                m_boxes.push_back(Box { shape->min + offset, shape->max + offset });
+            }
+        }
+    }
+    return { begin, static_cast<std::uint32_t>(m_boxes.size()) };
+}
+
+void BoxCache::gather(Box const &region, std::vector<Box> &boxes)
+{
+    using engine::world::chunk_shift;
+    using engine::world::chunk_size;
+    constexpr std::int32_t brick_size = Occupancy::brick_size;
+
+    glm::ivec3 const first = glm::ivec3 { glm::floor(region.min) };
+    glm::ivec3 const last = glm::ivec3 { glm::floor(region.max) };
+    glm::ivec3 const first_chunk = first >> chunk_shift;
+    glm::ivec3 const last_chunk = last >> chunk_shift;
+
+    for (std::int32_t cx = first_chunk.x; cx <= last_chunk.x; ++cx) {
+        for (std::int32_t cy = first_chunk.y; cy <= last_chunk.y; ++cy) {
+            for (std::int32_t cz = first_chunk.z; cz <= last_chunk.z; ++cz) {
+                auto &cached = chunk(engine::components::ChunkPosition { cx, cy, cz, m_dimension->id() });
+                if (!cached.occupancy || !cached.occupancy->bricks) continue;
+
+                // the part of the region inside this chunk, in local coordinates
+                glm::ivec3 const origin = glm::ivec3 { cx, cy, cz } * chunk_size;
+                glm::ivec3 const lo = glm::max(first - origin, glm::ivec3 { 0 }) / brick_size;
+                glm::ivec3 const hi = glm::min(last - origin, glm::ivec3 { chunk_size - 1 }) / brick_size;
+
+                for (std::int32_t bx = lo.x; bx <= hi.x; ++bx) {
+                    for (std::int32_t by = lo.y; by <= hi.y; ++by) {
+                        for (std::int32_t bz = lo.z; bz <= hi.z; ++bz) {
+                            auto const brick = Occupancy::brick_of(bx * brick_size, by * brick_size, bz * brick_size);
+                            if (!(cached.occupancy->bricks >> brick & 1u)) continue;
+
+                            auto &range = cached.bricks[brick];
+                            if (!range) range = gather_brick(cached, origin, brick);
+                            boxes.insert(boxes.end(), m_boxes.begin() + range->first, m_boxes.begin() + range->second);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// how far the body can go along an axis before it hits the block
+static float clip(Box const &body, Box const &block, int axis, float distance) noexcept
+{
+    for (int other = 0; other < 3; ++other) {
+        if (other == axis) continue;
+        if (body.max[other] <= block.min[other] + skin || body.min[other] >= block.max[other] - skin) return distance;
+    }
+
+    if (distance > 0.0f && body.max[axis] <= block.min[axis] + skin)
+        return std::min(distance, std::max(0.0f, block.min[axis] - body.max[axis] - skin));
+    if (distance < 0.0f && body.min[axis] >= block.max[axis] - skin)
+        return std::max(distance, std::min(0.0f, block.max[axis] - body.min[axis] + skin));
+    return distance;
+}
+
+// moves the box one axis at a time, vertical first, and returns how far it went
+static glm::vec3 sweep(Box &body, glm::vec3 motion, std::vector<Box> const &boxes) noexcept
+{
+    for (int axis : { 1, 0, 2 }) {
+        float distance = motion[axis];
+        if (distance == 0.0f) continue;
+        for (auto const &block : boxes)
+            distance = clip(body, block, axis, distance);
+        body.min[axis] += distance;
+        body.max[axis] += distance;
+        motion[axis] = distance;
+    }
+    return motion;
+}
+
+void engine::world::move_bodies(Dimension &dimension, CollisionShapes const &shapes, float delta)
+{
+    BoxCache cache { dimension, shapes };
+    std::vector<Box> boxes;
+    dimension.registry().view<engine::components::Body>().each([&](engine::components::Body &body) {
+        glm::vec3 const wanted = body.velocity * delta;
+
+        Box const start { body.position + grid_offset - body.half_extents, body.position + grid_offset + body.half_extents };
+
+        // everything the body could touch on its way, stepping up and the ground below included
+        Box region { start.min + glm::min(wanted, glm::vec3 { 0.0f }), start.max + glm::max(wanted, glm::vec3 { 0.0f }) };
+        region.min.y -= ground_probe;
+        region.max.y += body.step_height;
+        boxes.clear();
+        cache.gather(region, boxes);
+
+        Box moved_box = start;
+        glm::vec3 moved = sweep(moved_box, wanted, boxes);
+
+        bool const blocked_horizontally = moved.x != wanted.x || moved.z != wanted.z;
+        bool const landed = wanted.y < 0.0f && moved.y != wanted.y;
+        if (body.step_height > 0.0f && blocked_horizontally && (body.on_ground || landed)) {
+            // go up, then forward, then back down onto the ledge
+            Box stepped_box = start;
+            auto stepped = sweep(stepped_box, glm::vec3 { wanted.x, body.step_height, wanted.z }, boxes);
+            stepped.y += sweep(stepped_box, glm::vec3 { 0.0f, -stepped.y + std::min(wanted.y, 0.0f), 0.0f }, boxes).y;
+
+            if (stepped.x * stepped.x + stepped.z * stepped.z > moved.x * moved.x + moved.z * moved.z) {
+                moved_box = stepped_box;
+                moved = stepped;
+            }
+        }
+
+        body.position += moved_box.min - start.min;
+        for (int axis = 0; axis < 3; ++axis)
+            if (moved[axis] != wanted[axis]) body.velocity[axis] = 0.0f;
+
+        // a body standing still or walking is on the ground as much as a falling one that landed
+        Box probe = moved_box;
+        body.on_ground = sweep(probe, glm::vec3 { 0.0f, -ground_probe, 0.0f }, boxes).y > -ground_probe;
+    });
+}
\ No newline at end of file
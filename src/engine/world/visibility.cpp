@@ -0,0 +1,56 @@
+#include <engine/world/visibility.hpp>
+
+#include <bitset>
+
+engine::world::FaceConnectivity engine::world::face_connectivity(ChunkBlocks blocks, engine::named_storage<engine::BlockType> const &block_types)
+{
+    constexpr auto block_count = engine::components::ChunkData::block_count;
+    constexpr auto size = static_cast<std::uint32_t>(chunk_size);
+
+    std::bitset<block_count> closed;
+    for (std::size_t i = 0; i < block_count; ++i) {
+        auto const type_id = blocks[i].type_id;
+        closed[i] = type_id != entt::null && block_types.get(static_cast<entt::entity>(type_id)).opaque;
+    }
+    if (closed.none()) return FaceConnectivity::open();
+
+    FaceConnectivity result;
+    std::uint16_t stack[block_count];
+    for (std::size_t start = 0; start < block_count; ++start) {
+        if (closed[start]) continue;
+
+        // every block is closed once visited, so each is pushed at most once
+        std::size_t top = 0;
+        stack[top++] = static_cast<std::uint16_t>(start);
+        closed[start] = true;
+        std::uint8_t faces = 0;
+        while (top != 0) {
+            auto const index = stack[--top];
+            std::uint32_t const x = index / (size * size);
+            std::uint32_t const y = index / size % size;
+            std::uint32_t const z = index % size;
+
+            auto const visit = [&](bool inside, engine::Sides face, std::uint32_t nx, std::uint32_t ny, std::uint32_t nz) {
+                if (!inside) {
+                    faces |= face;
+                    return;
+                }
+                auto const neighbour = block_index(nx, ny, nz);
+                if (closed[neighbour]) return;
+                closed[neighbour] = true;
+                stack[top++] = static_cast<std::uint16_t>(neighbour);
+            };
+            visit(x != 0, engine::Sides::WEST, x - 1, y, z);
+            visit(x != size - 1, engine::Sides::EAST, x + 1, y, z);
+            visit(y != 0, engine::Sides::BOTTOM, x, y - 1, z);
+            visit(y != size - 1, engine::Sides::TOP, x, y + 1, z);
+            visit(z != 0, engine::Sides::NORTH, x, y, z - 1);
+            visit(z != size - 1, engine::Sides::SOUTH, x, y, z + 1);
+        }
+
+        for (int face = 0; face < 6; ++face)
+            if (faces >> face & 1)
+                result.connected[face] = static_cast<engine::Sides>(result.connected[face] | faces);
+    }
+    return result;
+}
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include <engine/Camera.hpp>
 #include <engine/Config.hpp>
 #include <engine/Game.hpp>
+#include <engine/ecs/components/Body.hpp>
+#include <engine/ecs/components/Camera.hpp>
 #include <engine/ecs/components/Dirty.hpp>
+#include <engine/ecs/components/LocalPlayer.hpp>
+#include <engine/ecs/components/MappedChunkData.hpp>
+#include <engine/ecs/components/Modified.hpp>
 #include <engine/rendering/opengl/Renderer.hpp>
 #include <math/bits.hpp>
 
@@ -9,7 +14,12 @@
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
 
+#include <algorithm>
+#include <future>
 #include <random>
+#include <span>
+#include <thread>
+#include <vector>
 
 engine::Camera g_camera;
 
@@ -25,31 +35,23 @@ void engine::Game::start()
     m_renderer->setup();
     m_renderer->imgui_setup();
 
-    m_entity_registry.on_construct<engine::components::ChunkPosition>().connect<&Game::on_chunk_construct>(*this);
-    m_entity_registry.on_destroy<engine::components::ChunkPosition>().connect<&Game::on_chunk_destroy>(*this);
+    m_collision_shapes = engine::world::CollisionShapes(m_block_registry, m_block_meshes);
 
-    auto const maybe_colorful_id = m_block_registry.index("colorful_block");
+    // the game thread ticks one of the dimensions too
+    m_dimension_pool.emplace(&Game::tick_dimension, std::max(2u, std::thread::hardware_concurrency()) - 1);
+
+    m_world_storage.emplace(engine::config().folders.saves / "world", engine::config().world.uncompressed ? engine::world::Compression::none : engine::world::Compression::rle);
+    m_async_io = engine::system::make_async_io();
+    m_chunk_streamer.emplace(*m_world_storage, *m_async_io);
+    m_world_saver.emplace(*m_world_storage);
+
+    place_local_player(g_camera.position);
 
     running = true;
-    std::random_device rd {};
-    std::uniform_int_distribution<std::uint16_t> color_dist { 0, 255 };
-    std::uniform_int_distribution<std::size_t> id_dist { 0, m_block_registry.size() };
 
     int32_t const max_x = 10;
-    for (std::int32_t x = 0; x < max_x; ++x) {
-        auto chunk = m_entity_registry.create();
-        m_entity_registry.emplace<engine::components::ChunkPosition>(chunk, x - max_x / 2);
-        auto &chunk_data = m_entity_registry.emplace<engine::components::ChunkData>(chunk);
-        m_entity_registry.emplace<engine::components::Dirty>(chunk);
-
-        for (auto &block : chunk_data.blocks) {
-            if (maybe_colorful_id != entt::null) {
-                if ((block.type_id = static_cast<entt::id_type>(block_registry().storage()[id_dist(rd)])) == static_cast<entt::id_type>(maybe_colorful_id)) {
-                    block.data_id = math::pack_u32(color_dist(rd), color_dist(rd), color_dist(rd));
-                }
-            }
-        }
-    }
+    for (std::int32_t x = 0; x < max_x; ++x)
+        request_chunk(engine::components::ChunkPosition { x - max_x / 2 });
 }
 
 void engine::Game::render()
@@ -59,18 +61,124 @@ void engine::Game::render()
     m_renderer->render(1.0f);
 }
 
-void engine::Game::on_chunk_construct(entt::registry &registry, entt::entity chunk)
+engine::world::Dimension &engine::Game::dimension(std::int32_t id)
+{
+    auto &dimension = m_dimensions[id];
+    if (!dimension)
+        dimension = std::make_unique<engine::world::Dimension>(id, m_block_registry);
+    return *dimension;
+}
+
+engine::world::Dimension const *engine::Game::find_dimension(std::int32_t id) const noexcept
+{
+    auto const it = m_dimensions.find(id);
+    return it == m_dimensions.end() ? nullptr : it->second.get();
+}
+
+std::optional<engine::world::RaycastHit> engine::Game::raycast(std::int32_t dimension, glm::vec3 origin, glm::vec3 direction, float max_distance) const noexcept
+{
+    auto const *const found = find_dimension(dimension);
+    if (!found) return std::nullopt;
+    return found->raycast(origin, direction, max_distance);
+}
+
+void engine::Game::place_local_player(glm::vec3 camera_position)
+{
+    using engine::components::LocalPlayer;
+    auto &registry = this->registry();
+    if (m_local_player == entt::null) {
+        m_local_player = registry.create();
+        registry.emplace<LocalPlayer>(m_local_player);
+        registry.emplace<engine::components::Camera>(m_local_player);
+        registry.emplace<engine::components::Body>(m_local_player, engine::components::Body { .half_extents = glm::vec3 { 0.3f, 0.9f, 0.3f }, .step_height = 0.5f });
+    }
+    // bodies are in world coordinates, where x goes the other way than the camera's
+    registry.get<engine::components::Body>(m_local_player).position = glm::vec3 { -camera_position.x, camera_position.y - LocalPlayer::eye_height, camera_position.z };
+}
+
+void engine::Game::request_chunk(engine::components::ChunkPosition const &position)
+{
+    if (dimension(position.dimension).chunk(position) != entt::null) return;
+    m_chunk_streamer->request(position);
+}
+
+void engine::Game::stream_chunks()
+{
+    for (auto &result : m_chunk_streamer->poll())
+        dimension(result.position.dimension).deliver(std::move(result));
+}
+
+void engine::Game::tick_dimensions(float delta, bool autosave)
 {
-    assert(&m_entity_registry == &registry); // sanity check
-    auto const &chunk_position = registry.get<engine::components::ChunkPosition>(chunk);
-    m_chunks.emplace(chunk_position, chunk);
+    std::vector<engine::world::Dimension *> busy;
+    for (auto &[id, dimension] : m_dimensions)
+        if (autosave || !dimension->is_idle())
+            busy.push_back(dimension.get());
+    if (busy.empty()) return;
+
+    std::vector<std::future<void>> ticks;
+    ticks.reserve(busy.size() - 1);
+    for (auto *dimension : std::span(busy).subspan(1))
+        ticks.push_back(m_dimension_pool->submit(this, std::move(dimension), float { delta }, bool { autosave }));
+
+    tick_dimension(this, busy.front(), delta, autosave);
+    for (auto &tick : ticks)
+        tick.get();
 }
 
-void engine::Game::on_chunk_destroy(entt::registry &registry, entt::entity chunk)
+void engine::Game::tick_dimension(Game *game, engine::world::Dimension *dimension, float delta, bool autosave)
 {
-    assert(&m_entity_registry == &registry); // sanity check
-    auto const &chunk_position = registry.get<engine::components::ChunkPosition>(chunk);
-    m_chunks.erase(chunk_position);
+    auto &registry = dimension->registry();
+    for (auto &result : dimension->take_arrived()) {
+        if (dimension->chunk(result.position) != entt::null) continue;
+
+        if (std::holds_alternative<std::monostate>(result.chunk)) {
+            game->generate_chunk(*dimension, result.position);
+            continue;
+        }
+
+        // uncompressed chunks are used straight from the region file
+        auto chunk = registry.create();
+        registry.emplace<engine::components::ChunkPosition>(chunk, result.position);
+        if (auto *mapped = std::get_if<engine::components::MappedChunkData>(&result.chunk))
+            registry.emplace<engine::components::MappedChunkData>(chunk, std::move(*mapped));
+        else
+            registry.emplace<engine::components::ChunkData>(chunk, *std::get<std::unique_ptr<engine::components::ChunkData>>(result.chunk));
+        registry.emplace<engine::components::Dirty>(chunk);
+        dimension->chunk_loaded(chunk);
+    }
+
+    engine::world::move_bodies(*dimension, game->m_collision_shapes, delta);
+
+    if (autosave)
+        game->m_world_saver->save_modified(registry);
+}
+
+entt::entity engine::Game::generate_chunk(engine::world::Dimension &dimension, engine::components::ChunkPosition const &position)
+{
+    auto const maybe_colorful_id = m_block_registry.index("colorful_block");
+
+    std::random_device rd {};
+    std::uniform_int_distribution<std::uint16_t> color_dist { 0, 255 };
+    std::uniform_int_distribution<std::size_t> id_dist { 0, m_block_registry.size() };
+
+    auto &registry = dimension.registry();
+    auto chunk = registry.create();
+    registry.emplace<engine::components::ChunkPosition>(chunk, position);
+    auto &chunk_data = registry.emplace<engine::components::ChunkData>(chunk);
+    registry.emplace<engine::components::Dirty>(chunk);
+    registry.emplace<engine::components::Modified>(chunk);
+
+    for (std::size_t i = 0; i < engine::components::ChunkData::block_count; ++i) {
+        auto &block = chunk_data.blocks[i];
+        if (maybe_colorful_id != entt::null) {
+            if ((block.type_id = static_cast<entt::id_type>(block_registry().storage()[id_dist(rd)])) == static_cast<entt::id_type>(maybe_colorful_id)) {
+                chunk_data.payloads.set(i, math::pack_u32(color_dist(rd), color_dist(rd), color_dist(rd)));
+            }
+        }
+    }
+    dimension.chunk_loaded(chunk);
+    return chunk;
 }
 
 void engine::Game::stop()
@@ -84,7 +192,23 @@ void engine::Game::cleanup()
     m_renderer = nullptr;
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
-    m_entity_registry.clear();
+
+    if (m_dimension_pool) {
+        m_dimension_pool->stop();
+        m_dimension_pool.reset();
+    }
+
+    // pending loads read from the region files
+    m_chunk_streamer.reset();
+    m_async_io = nullptr;
+
+    if (m_world_saver) {
+        for (auto &[id, dimension] : m_dimensions)
+            m_world_saver->save_modified(dimension->registry());
+        m_world_saver.reset();
+    }
+    m_world_storage.reset();
+    m_dimensions.clear();
 }
 
 engine::Game::~Game()
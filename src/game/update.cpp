@@ -1,5 +1,8 @@
 #include <engine/Camera.hpp>
+#include <engine/Config.hpp>
 #include <engine/Game.hpp>
+#include <engine/ecs/components/Camera.hpp>
+#include <engine/ecs/system.hpp>
 
 #include <SDL_keyboard.h>
 #include <SDL_scancode.h>
@@ -18,6 +21,20 @@ void engine::Game::update(std::chrono::duration<double> delta)
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 
+    stream_chunks();
+
+    m_since_autosave += delta;
+    bool const autosave = m_since_autosave.count() >= engine::config().world.autosave_interval;
+    if (autosave) m_since_autosave = {};
+    tick_dimensions(static_cast<float>(delta.count()), autosave);
+
+    // the mouse turns the global camera, the local player's body carries it around
+    auto &camera = registry().get<engine::components::Camera>(m_local_player);
+    camera.forward = g_camera.forward;
+    camera.up = g_camera.up;
+    engine::ecs::run_systems(registry(), delta);
+    g_camera.position = camera.position;
+
     if (ImGui::Begin("Camera")) {
         ImGui::SliderFloat("FOV", &g_camera.fov, 30.0f, 130.0f);
         ImGui::SliderFloat("Mouse speed", &g_mouse_sensitivity, 0.1f, 10.0f);
@@ -26,8 +43,10 @@ void engine::Game::update(std::chrono::duration<double> delta)
         ImGui::Text("Position: % .5f % .5f % .5f", g_camera.position.x, g_camera.position.y, g_camera.position.z);
         ImGui::Text("Forward : % .5f % .5f % .5f", g_camera.forward.x, g_camera.forward.y, g_camera.forward.z);
 
-        if (ImGui::Button("Reset"))
+        if (ImGui::Button("Reset")) {
             g_camera = engine::Camera {};
+            place_local_player(g_camera.position);
+        }
     }
     ImGui::End();
     if (ImGui::Begin("Random Stuff")) {
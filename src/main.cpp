@@ -127,6 +127,9 @@ int main(int argc, char **argv)
 
     {
         char const *video_driver = config.sdl.video_driver ? config.sdl.video_driver->c_str() : nullptr;
+        // creates its contexts with EGL, which works without a display with mesa's surfaceless platform
+        if (!video_driver && config.rendering.headless.enabled)
+            video_driver = "offscreen";
         if (int const error = SDL_VideoInit(video_driver); error != 0) {
             SPDLOG_ERROR("Failed to initialize SDL Video subsystem ({}): {}", error, SDL_GetError());
             throw std::runtime_error(SDL_GetError());
@@ -0,0 +1,73 @@
+#include <math/frustum.hpp>
+#include <math/frustum_impl.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <cassert>
+
+math::Frustum math::Frustum::from_matrix(glm::mat4 const &m) noexcept
+{
+    // Gribb & Hartmann, the planes are rows of the matrix added to or subtracted from the last one
+    // they aren't normalized, the tests only care about the sign
+    auto const row = [&](int i) { return glm::vec4 { m[0][i], m[1][i], m[2][i], m[3][i] }; };
+    return Frustum {
+        .planes = {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(3) + row(2),
+            row(3) - row(2),
+        },
+    };
+}
+
+bool math::Frustum::intersects(glm::vec3 center, glm::vec3 half_extents) const noexcept
+{
+    for (auto const &plane : planes) {
+        glm::vec3 const normal { plane };
+        // distance from the center to the corner furthest along the normal
+        if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), half_extents) < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void math::frustum_impl::cull_scalar(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        bool inside = true;
+        for (auto const &plane : planes)
+            inside &= !(plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3] < 0.0f);
+        visible[i] = inside;
+    }
+}
+
+static math::frustum_impl::cull_function select_kernel() noexcept
+{
+#ifdef MATH_FRUSTUM_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) return &math::frustum_impl::cull_avx;
+    if (__builtin_cpu_supports("sse2")) return &math::frustum_impl::cull_sse2;
+#endif
+    return &math::frustum_impl::cull_scalar;
+}
+
+void math::cull_boxes(Frustum const &frustum, glm::vec3 half_extents, std::span<float const> x, std::span<float const> y, std::span<float const> z, std::span<std::uint8_t> visible)
+{
+    assert(x.size() == y.size() && x.size() == z.size() && x.size() <= visible.size());
+    static frustum_impl::cull_function const kernel = select_kernel();
+
+    float planes[6][4];
+    for (std::size_t i = 0; i < 6; ++i) {
+        auto const &plane = frustum.planes[i];
+        glm::vec3 const normal { plane };
+        planes[i][0] = plane.x;
+        planes[i][1] = plane.y;
+        planes[i][2] = plane.z;
+        planes[i][3] = plane.w + glm::dot(glm::abs(normal), half_extents);
+    }
+
+    kernel(planes, x.data(), y.data(), z.data(), x.size(), visible.data());
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx")
+
+#include <math/frustum_impl.hpp>
+
+// 8 boxes per iteration, the remainder goes through the scalar kernel
+void math::frustum_impl::cull_avx(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible)
+{
+    __m256 nx[6], ny[6], nz[6], w[6];
+    for (int p = 0; p < 6; ++p) {
+        nx[p] = _mm256_set1_ps(planes[p][0]);
+        ny[p] = _mm256_set1_ps(planes[p][1]);
+        nz[p] = _mm256_set1_ps(planes[p][2]);
+        w[p] = _mm256_set1_ps(planes[p][3]);
+    }
+    __m256 const zero = _mm256_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 const cx = _mm256_loadu_ps(x + i), cy = _mm256_loadu_ps(y + i), cz = _mm256_loadu_ps(z + i);
+        __m256 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            __m256 const distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)), _mm256_add_ps(_mm256_mul_ps(nz[p], cz), w[p]));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, zero, _CMP_LT_OQ));
+        }
+        int const mask = _mm256_movemask_ps(outside);
+        for (int lane = 0; lane < 8; ++lane)
+            visible[i + lane] = !(mask >> lane & 1);
+    }
+
+    cull_scalar(planes, x + i, y + i, z + i, count - i, visible + i);
+}
+
+#pragma GCC pop_options
+
+#endif
\ No newline at end of file
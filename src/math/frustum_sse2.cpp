@@ -0,0 +1,43 @@
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <math/frustum_impl.hpp>
+
+// 4 boxes per iteration, the remainder goes through the scalar kernel
+void math::frustum_impl::cull_sse2(float const (&planes)[6][4], float const *x, float const *y, float const *z, std::size_t count, std::uint8_t *visible)
+{
+    __m128 nx[6], ny[6], nz[6], w[6];
+    for (int p = 0; p < 6; ++p) {
+        nx[p] = _mm_set1_ps(planes[p][0]);
+        ny[p] = _mm_set1_ps(planes[p][1]);
+        nz[p] = _mm_set1_ps(planes[p][2]);
+        w[p] = _mm_set1_ps(planes[p][3]);
+    }
+    __m128 const zero = _mm_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 const cx = _mm_loadu_ps(x + i), cy = _mm_loadu_ps(y + i), cz = _mm_loadu_ps(z + i);
+        __m128 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            __m128 const distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_add_ps(_mm_mul_ps(nz[p], cz), w[p]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+        int const mask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; ++lane)
+            visible[i + lane] = !(mask >> lane & 1);
+    }
+
+    cull_scalar(planes, x + i, y + i, z + i, count - i, visible + i);
+}
+
+#pragma GCC pop_options
+
+#endif
\ No newline at end of file
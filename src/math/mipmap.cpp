@@ -0,0 +1,39 @@
+#include <math/mipmap.hpp>
+#include <math/mipmap_impl.hpp>
+
+#include <cassert>
+#include <cstddef>
+
+void math::mipmap_impl::downsample_scalar(std::uint8_t const *row0, std::uint8_t const *row1, std::uint32_t width, std::uint8_t *dst)
+{
+    auto const dst_width = mip_size(width);
+    for (std::uint32_t i = 0; i < dst_width; ++i) {
+        std::uint32_t const x0 = 2 * i * 4;
+        std::uint32_t const x1 = std::min(2 * i + 1, width - 1) * 4;
+        for (std::uint32_t c = 0; c < 4; ++c)
+            dst[i * 4 + c] = static_cast<std::uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+    }
+}
+
+static math::mipmap_impl::downsample_function select_kernel() noexcept
+{
+#ifdef MATH_MIPMAP_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) return &math::mipmap_impl::downsample_sse2;
+#endif
+    return &math::mipmap_impl::downsample_scalar;
+}
+
+void math::downsample_rgba8(std::span<std::uint8_t const> src, std::uint32_t width, std::uint32_t height, std::span<std::uint8_t> dst)
+{
+    auto const dst_width = mip_size(width), dst_height = mip_size(height);
+    assert(src.size() >= std::size_t { width } * height * 4 && dst.size() >= std::size_t { dst_width } * dst_height * 4);
+    static mipmap_impl::downsample_function const kernel = select_kernel();
+
+    std::size_t const pitch = std::size_t { width } * 4;
+    for (std::uint32_t y = 0; y < dst_height; ++y) {
+        auto const *const row0 = src.data() + 2 * y * pitch;
+        auto const *const row1 = src.data() + std::min(2 * y + 1, height - 1) * pitch;
+        kernel(row0, row1, width, dst.data() + y * std::size_t { dst_width } * 4);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <math/mipmap_impl.hpp>
+
+// 4 pixels of the next level per iteration from 8 of each row, the remainder goes through the scalar kernel
+void math::mipmap_impl::downsample_sse2(std::uint8_t const *row0, std::uint8_t const *row1, std::uint32_t width, std::uint8_t *dst)
+{
+    std::uint32_t const dst_width = width > 1 ? width / 2 : 1;
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const round = _mm_set1_epi16(2);
+
+    std::uint32_t i = 0;
+    for (; i + 4 <= dst_width; i += 4) {
+        __m128i const a0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0 + i * 8));
+        __m128i const b0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0 + i * 8 + 16));
+        __m128i const a1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1 + i * 8));
+        __m128i const b1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1 + i * 8 + 16));
+
+        // widened to 16 bits and summed down the columns, two pixels per register
+        __m128i const s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(a1, zero));
+        __m128i const s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(a1, zero));
+        __m128i const s45 = _mm_add_epi16(_mm_unpacklo_epi8(b0, zero), _mm_unpacklo_epi8(b1, zero));
+        __m128i const s67 = _mm_add_epi16(_mm_unpackhi_epi8(b0, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // even columns are in the low halves and odd ones in the high halves
+        __m128i const t0 = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+        __m128i const t1 = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+
+        __m128i const p0 = _mm_srli_epi16(_mm_add_epi16(t0, round), 2);
+        __m128i const p1 = _mm_srli_epi16(_mm_add_epi16(t1, round), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_packus_epi16(p0, p1));
+    }
+
+    // starting further along the rows gives the same columns
+    if (i < dst_width)
+        downsample_scalar(row0 + i * 8, row1 + i * 8, width - 2 * i, dst + i * 4);
+}
+
+#pragma GCC pop_options
+
+#endif
\ No newline at end of file
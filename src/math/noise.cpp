@@ -0,0 +1,163 @@
+#include <math/noise.hpp>
+#include <math/noise_impl.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+    // reference implementation, a single lane
+    struct Scalar {
+        using F = float;
+        using I = std::uint32_t;
+        using M = bool;
+
+        static constexpr std::size_t width = 1;
+
+        static F fset(float v) noexcept { return v; }
+        static I iset(std::uint32_t v) noexcept { return v; }
+        static I iota() noexcept { return 0; }
+
+        static F add(F a, F b) noexcept { return a + b; }
+        static F sub(F a, F b) noexcept { return a - b; }
+        static F mul(F a, F b) noexcept { return a * b; }
+        static F min(F a, F b) noexcept { return b < a ? b : a; }
+        static F max(F a, F b) noexcept { return a < b ? b : a; }
+        static F sqrt(F a) noexcept { return std::sqrt(a); }
+        static F floor(F a) noexcept { return std::floor(a); }
+
+        static I to_int(F a) noexcept { return static_cast<std::uint32_t>(static_cast<std::int32_t>(a)); }
+        static F to_float(I a) noexcept { return static_cast<float>(static_cast<std::int32_t>(a)); }
+
+        static I iadd(I a, I b) noexcept { return a + b; }
+        static I imul(I a, I b) noexcept { return a * b; }
+        static I ixor(I a, I b) noexcept { return a ^ b; }
+        static I iand(I a, I b) noexcept { return a & b; }
+        template <int N>
+        static I srl(I a) noexcept { return a >> N; }
+
+        static M gt(F a, F b) noexcept { return a > b; }
+        static M ge(F a, F b) noexcept { return a >= b; }
+        static M ilt(I a, I b) noexcept { return static_cast<std::int32_t>(a) < static_cast<std::int32_t>(b); }
+        static M ieq(I a, I b) noexcept { return a == b; }
+        static M mand(M a, M b) noexcept { return a && b; }
+        static M mor(M a, M b) noexcept { return a || b; }
+        static M mnot(M a) noexcept { return !a; }
+
+        static F select(M m, F a, F b) noexcept { return m ? a : b; }
+        static I iselect(M m, I a, I b) noexcept { return m ? a : b; }
+        static F negate_if(M m, F a) noexcept { return m ? -a : a; }
+
+        static void store(float *out, F a) noexcept { *out = a; }
+    };
+
+}
+
+void math::noise::impl::fill_2d_scalar(Settings const &settings, std::int32_t x, std::int32_t z, float *out)
+{
+    impl::fill_2d<Scalar>(settings, x, z, out);
+}
+
+void math::noise::impl::fill_3d_scalar(Settings const &settings, std::int32_t x, std::int32_t y, std::int32_t z, float *out)
+{
+    impl::fill_3d<Scalar>(settings, x, y, z, out);
+}
+
+static char const *kernel_name(math::noise::Kernel kernel) noexcept
+{
+    using math::noise::Kernel;
+    switch (kernel) {
+    case Kernel::scalar: return "scalar";
+    case Kernel::sse2: return "sse2";
+    case Kernel::avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+bool math::noise::is_supported(Kernel kernel) noexcept
+{
+#ifdef MATH_NOISE_X86_KERNELS
+    __builtin_cpu_init();
+#endif
+    switch (kernel) {
+    case Kernel::scalar: return true;
+#ifdef MATH_NOISE_X86_KERNELS
+    case Kernel::sse2: return __builtin_cpu_supports("sse2");
+    case Kernel::avx2: return __builtin_cpu_supports("avx2");
+#else
+    case Kernel::sse2: return false;
+    case Kernel::avx2: return false;
+#endif
+    }
+    return false;
+}
+
+static math::noise::impl::fill_2d_function get_fill_2d(math::noise::Kernel kernel) noexcept
+{
+    using math::noise::Kernel;
+    switch (kernel) {
+#ifdef MATH_NOISE_X86_KERNELS
+    case Kernel::sse2: return &math::noise::impl::fill_2d_sse2;
+    case Kernel::avx2: return &math::noise::impl::fill_2d_avx2;
+#endif
+    default: return &math::noise::impl::fill_2d_scalar;
+    }
+}
+
+static math::noise::impl::fill_3d_function get_fill_3d(math::noise::Kernel kernel) noexcept
+{
+    using math::noise::Kernel;
+    switch (kernel) {
+#ifdef MATH_NOISE_X86_KERNELS
+    case Kernel::sse2: return &math::noise::impl::fill_3d_sse2;
+    case Kernel::avx2: return &math::noise::impl::fill_3d_avx2;
+#endif
+    default: return &math::noise::impl::fill_3d_scalar;
+    }
+}
+
+static math::noise::Kernel select_kernel() noexcept
+{
+    using math::noise::Kernel;
+
+    for (auto const kernel : { Kernel::avx2, Kernel::sse2 }) {
+        if (math::noise::is_supported(kernel))
+            return kernel;
+    }
+    return Kernel::scalar;
+}
+
+math::noise::Kernel math::noise::kernel() noexcept
+{
+    static Kernel const _value = []() {
+        auto const kernel = select_kernel();
+        SPDLOG_INFO("using noise kernel {}", kernel_name(kernel));
+        return kernel;
+    }();
+
+    return _value;
+}
+
+void math::noise::fill_2d(Settings const &settings, glm::ivec2 origin, Grid2D out)
+{
+    return fill_2d(kernel(), settings, origin, out);
+}
+
+void math::noise::fill_2d(Kernel kernel, Settings const &settings, glm::ivec2 origin, Grid2D out)
+{
+    if (!is_supported(kernel)) kernel = Kernel::scalar;
+    get_fill_2d(kernel)(settings, origin.x, origin.y, out.data());
+}
+
+void math::noise::fill_3d(Settings const &settings, glm::ivec3 origin, Grid3D out)
+{
+    return fill_3d(kernel(), settings, origin, out);
+}
+
+void math::noise::fill_3d(Kernel kernel, Settings const &settings, glm::ivec3 origin, Grid3D out)
+{
+    if (!is_supported(kernel)) kernel = Kernel::scalar;
+    get_fill_3d(kernel)(settings, origin.x, origin.y, origin.z, out.data());
+}
@@ -0,0 +1,76 @@
+#include <math/noise.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// fma is left out on purpose, contracting would make the results drift away from the scalar reference
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include <math/noise_impl.hpp>
+
+namespace {
+
+    struct Avx2 {
+        using F = __m256;
+        using I = __m256i;
+        using M = __m256;
+
+        static constexpr std::size_t width = 8;
+
+        static F fset(float v) noexcept { return _mm256_set1_ps(v); }
+        static I iset(std::uint32_t v) noexcept { return _mm256_set1_epi32(static_cast<int>(v)); }
+        static I iota() noexcept { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+        static F add(F a, F b) noexcept { return _mm256_add_ps(a, b); }
+        static F sub(F a, F b) noexcept { return _mm256_sub_ps(a, b); }
+        static F mul(F a, F b) noexcept { return _mm256_mul_ps(a, b); }
+        static F min(F a, F b) noexcept { return _mm256_min_ps(a, b); }
+        static F max(F a, F b) noexcept { return _mm256_max_ps(a, b); }
+        static F sqrt(F a) noexcept { return _mm256_sqrt_ps(a); }
+        static F floor(F a) noexcept { return _mm256_floor_ps(a); }
+
+        static I to_int(F a) noexcept { return _mm256_cvttps_epi32(a); }
+        static F to_float(I a) noexcept { return _mm256_cvtepi32_ps(a); }
+
+        static I iadd(I a, I b) noexcept { return _mm256_add_epi32(a, b); }
+        static I imul(I a, I b) noexcept { return _mm256_mullo_epi32(a, b); }
+        static I ixor(I a, I b) noexcept { return _mm256_xor_si256(a, b); }
+        static I iand(I a, I b) noexcept { return _mm256_and_si256(a, b); }
+        template <int N>
+        static I srl(I a) noexcept { return _mm256_srli_epi32(a, N); }
+
+        static M gt(F a, F b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static M ge(F a, F b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static M ilt(I a, I b) noexcept { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+        static M ieq(I a, I b) noexcept { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+        static M mand(M a, M b) noexcept { return _mm256_and_ps(a, b); }
+        static M mor(M a, M b) noexcept { return _mm256_or_ps(a, b); }
+        static M mnot(M a) noexcept { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+
+        static F select(M m, F a, F b) noexcept { return _mm256_blendv_ps(b, a, m); }
+        static I iselect(M m, I a, I b) noexcept { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m)); }
+        static F negate_if(M m, F a) noexcept { return _mm256_xor_ps(a, _mm256_and_ps(m, _mm256_set1_ps(-0.0f))); }
+
+        static void store(float *out, F a) noexcept { _mm256_storeu_ps(out, a); }
+    };
+
+}
+
+void math::noise::impl::fill_2d_avx2(Settings const &settings, std::int32_t x, std::int32_t z, float *out)
+{
+    impl::fill_2d<Avx2>(settings, x, z, out);
+}
+
+void math::noise::impl::fill_3d_avx2(Settings const &settings, std::int32_t x, std::int32_t y, std::int32_t z, float *out)
+{
+    impl::fill_3d<Avx2>(settings, x, y, z, out);
+}
+
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,92 @@
+#include <math/noise.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <math/noise_impl.hpp>
+
+namespace {
+
+    struct Sse2 {
+        using F = __m128;
+        using I = __m128i;
+        using M = __m128;
+
+        static constexpr std::size_t width = 4;
+
+        static F fset(float v) noexcept { return _mm_set1_ps(v); }
+        static I iset(std::uint32_t v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+        static I iota() noexcept { return _mm_setr_epi32(0, 1, 2, 3); }
+
+        static F add(F a, F b) noexcept { return _mm_add_ps(a, b); }
+        static F sub(F a, F b) noexcept { return _mm_sub_ps(a, b); }
+        static F mul(F a, F b) noexcept { return _mm_mul_ps(a, b); }
+        static F min(F a, F b) noexcept { return _mm_min_ps(a, b); }
+        static F max(F a, F b) noexcept { return _mm_max_ps(a, b); }
+        static F sqrt(F a) noexcept { return _mm_sqrt_ps(a); }
+
+        // no roundps before SSE4.1, truncate and fix up the negative values
+        static F floor(F a) noexcept
+        {
+            auto const truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+            return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.0f)));
+        }
+
+        static I to_int(F a) noexcept { return _mm_cvttps_epi32(a); }
+        static F to_float(I a) noexcept { return _mm_cvtepi32_ps(a); }
+
+        static I iadd(I a, I b) noexcept { return _mm_add_epi32(a, b); }
+        static I ixor(I a, I b) noexcept { return _mm_xor_si128(a, b); }
+        static I iand(I a, I b) noexcept { return _mm_and_si128(a, b); }
+        template <int N>
+        static I srl(I a) noexcept { return _mm_srli_epi32(a, N); }
+
+        // no pmulld before SSE4.1, multiply the even and odd lanes separately
+        static I imul(I a, I b) noexcept
+        {
+            auto const even = _mm_mul_epu32(a, b);
+            auto const odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+
+        static M gt(F a, F b) noexcept { return _mm_cmpgt_ps(a, b); }
+        static M ge(F a, F b) noexcept { return _mm_cmpge_ps(a, b); }
+        static M ilt(I a, I b) noexcept { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+        static M ieq(I a, I b) noexcept { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+        static M mand(M a, M b) noexcept { return _mm_and_ps(a, b); }
+        static M mor(M a, M b) noexcept { return _mm_or_ps(a, b); }
+        static M mnot(M a) noexcept { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+
+        static F select(M m, F a, F b) noexcept { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+        static I iselect(M m, I a, I b) noexcept
+        {
+            auto const mask = _mm_castps_si128(m);
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+        static F negate_if(M m, F a) noexcept { return _mm_xor_ps(a, _mm_and_ps(m, _mm_set1_ps(-0.0f))); }
+
+        static void store(float *out, F a) noexcept { _mm_storeu_ps(out, a); }
+    };
+
+}
+
+void math::noise::impl::fill_2d_sse2(Settings const &settings, std::int32_t x, std::int32_t z, float *out)
+{
+    impl::fill_2d<Sse2>(settings, x, z, out);
+}
+
+void math::noise::impl::fill_3d_sse2(Settings const &settings, std::int32_t x, std::int32_t y, std::int32_t z, float *out)
+{
+    impl::fill_3d<Sse2>(settings, x, y, z, out);
+}
+
+#pragma GCC pop_options
+
+#endif
@@ -0,0 +1,191 @@
+#include <math/occlusion.hpp>
+#include <math/occlusion_impl.hpp>
+
+#include <glm/common.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // corner i of a box has the max x if bit 0 is set, the max y if bit 1 is and the max z if bit 2 is
+    // faces are counter clockwise seen from outside the box
+    constexpr int box_faces[6][4] = {
+        { 0, 4, 6, 2 }, // -x
+        { 5, 1, 3, 7 }, // +x
+        { 0, 1, 5, 4 }, // -y
+        { 3, 2, 6, 7 }, // +y
+        { 1, 0, 2, 3 }, // -z
+        { 4, 5, 7, 6 }, // +z
+    };
+}
+
+void math::occlusion_impl::raster_scalar(float *depth, int width, int height, Occluder const &occluder)
+{
+    Setup s;
+    if (!setup(occluder, width, height, s)) return;
+
+    for (int y = s.min_y; y <= s.max_y; ++y) {
+        float const py = static_cast<float>(y) + 0.5f;
+        float *const row = depth + static_cast<std::ptrdiff_t>(y) * width;
+        for (int x = s.min_x; x <= s.max_x; ++x) {
+            float const px = static_cast<float>(x) + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < s.edge_count; ++i)
+                inside &= !(s.ey[i] * (py - s.oy[i]) - s.margin[i] + s.ex[i] * (px - s.ox[i]) < 0.0f);
+            if (!inside) continue;
+
+            // the box is convex, where it's in front of the camera it's as far as the farthest plane facing it
+            float z = s.pz[0] + s.pdy[0] * py + s.pdx[0] * px;
+            for (int i = 1; i < s.plane_count; ++i)
+                z = std::max(z, s.pz[i] + s.pdy[i] * py + s.pdx[i] * px);
+            row[x] = std::min(row[x], z);
+        }
+    }
+}
+
+static math::occlusion_impl::raster_function select_kernel() noexcept
+{
+#ifdef MATH_OCCLUSION_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) return &math::occlusion_impl::raster_sse2;
+#endif
+    return &math::occlusion_impl::raster_scalar;
+}
+
+math::OcclusionBuffer::OcclusionBuffer()
+    : m_projection_view(1.0f)
+{
+    for (int w = width, h = height;; w /= 2, h /= 2) {
+        m_levels.emplace_back(static_cast<std::size_t>(w) * h, 1.0f);
+        if (w == 1 || h == 1) break;
+    }
+}
+
+void math::OcclusionBuffer::clear(glm::mat4 const &projection_view)
+{
+    m_projection_view = projection_view;
+    std::ranges::fill(m_levels.front(), 1.0f);
+}
+
+bool math::OcclusionBuffer::project(glm::vec3 min, glm::vec3 max, glm::vec3 (&corners)[8]) const noexcept
+{
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 const corner { i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f };
+        glm::vec4 const clip = m_projection_view * corner;
+        if (clip.z < -clip.w || !(clip.w > 0.0f)) return false;
+
+        glm::vec3 const ndc = glm::vec3 { clip } / clip.w;
+        corners[i] = glm::vec3 {
+            (ndc.x * 0.5f + 0.5f) * width,
+            (ndc.y * 0.5f + 0.5f) * height,
+            ndc.z * 0.5f + 0.5f,
+        };
+    }
+    return true;
+}
+
+void math::OcclusionBuffer::add_occluder(glm::vec3 min, glm::vec3 max)
+{
+    static occlusion_impl::raster_function const kernel = select_kernel();
+
+    glm::vec3 corners[8];
+    if (!project(min, max, corners)) return;
+
+    occlusion_impl::Occluder occluder;
+
+    // the outline is the convex hull of the corners, built bottom then top from the leftmost one
+    int order[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    std::ranges::sort(order, [&](int a, int b) { return std::pair { corners[a].x, corners[a].y } < std::pair { corners[b].x, corners[b].y }; });
+    auto const turns_left = [&](int a, int b, int c) {
+        return (corners[b].x - corners[a].x) * (corners[c].y - corners[a].y) - (corners[b].y - corners[a].y) * (corners[c].x - corners[a].x) > 0.0f;
+    };
+    int hull[16];
+    int size = 0;
+    for (int i = 0; i < 8; ++i) {
+        while (size >= 2 && !turns_left(hull[size - 2], hull[size - 1], order[i])) --size;
+        hull[size++] = order[i];
+    }
+    for (int i = 6, bottom = size + 1; i >= 0; --i) {
+        while (size >= bottom && !turns_left(hull[size - 2], hull[size - 1], order[i])) --size;
+        hull[size++] = order[i];
+    }
+    // the last one closes the hull at the first one
+    occluder.vertex_count = size - 1;
+    for (int i = 0; i < occluder.vertex_count; ++i) {
+        occluder.x[i] = corners[hull[i]].x;
+        occluder.y[i] = corners[hull[i]].y;
+    }
+
+    // faces facing away end up clockwise
+    occluder.plane_count = 0;
+    for (auto const &quad : box_faces) {
+        auto const &a = corners[quad[0]];
+        auto const &b = corners[quad[1]];
+        auto const &c = corners[quad[2]];
+        float const area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (!(area > 0.0f) || occluder.plane_count == std::ssize(occluder.planes)) continue;
+
+        float const dzdx = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+        float const dzdy = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+        auto &plane = occluder.planes[occluder.plane_count++];
+        plane[0] = a.z - dzdx * a.x - dzdy * a.y;
+        plane[1] = dzdx;
+        plane[2] = dzdy;
+    }
+
+    kernel(m_levels.front().data(), width, height, occluder);
+}
+
+void math::OcclusionBuffer::build_hierarchy()
+{
+    for (std::size_t level = 1; level < m_levels.size(); ++level) {
+        auto const &source = m_levels[level - 1];
+        auto &destination = m_levels[level];
+        int const source_width = width >> (level - 1);
+        int const destination_width = width >> level;
+        int const destination_height = height >> level;
+        for (int y = 0; y < destination_height; ++y) {
+            for (int x = 0; x < destination_width; ++x) {
+                auto const *const texels = source.data() + static_cast<std::ptrdiff_t>(y) * 2 * source_width + x * 2;
+                destination[static_cast<std::size_t>(y) * destination_width + x] = std::max({ texels[0], texels[1], texels[source_width], texels[source_width + 1] });
+            }
+        }
+    }
+}
+
+bool math::OcclusionBuffer::is_occluded(glm::vec3 min, glm::vec3 max) const noexcept
+{
+    glm::vec3 corners[8];
+    if (!project(min, max, corners)) return false;
+
+    glm::vec3 lo = corners[0], hi = corners[0];
+    for (auto const &corner : corners) {
+        lo = glm::min(lo, corner);
+        hi = glm::max(hi, corner);
+    }
+    if (hi.x < 0.0f || hi.y < 0.0f || lo.x >= width || lo.y >= height) return false;
+
+    // every pixel the box may touch
+    int x0 = std::clamp(static_cast<int>(glm::floor(lo.x)), 0, width - 1);
+    int x1 = std::clamp(static_cast<int>(glm::floor(hi.x)), 0, width - 1);
+    int y0 = std::clamp(static_cast<int>(glm::floor(lo.y)), 0, height - 1);
+    int y1 = std::clamp(static_cast<int>(glm::floor(hi.y)), 0, height - 1);
+
+    // the first level where that is at most 2x2 texels
+    std::size_t level = 0;
+    while (level + 1 < m_levels.size() && (x1 - x0 > 1 || y1 - y0 > 1)) {
+        ++level;
+        x0 /= 2;
+        x1 /= 2;
+        y0 /= 2;
+        y1 /= 2;
+    }
+
+    auto const &texels = m_levels[level];
+    int const level_width = width >> level;
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            if (!(texels[static_cast<std::size_t>(y) * level_width + x] < lo.z)) return false;
+    return true;
+}
\ No newline at end of file
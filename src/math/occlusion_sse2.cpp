@@ -0,0 +1,59 @@
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <math/occlusion_impl.hpp>
+
+// spans of 4 pixels aligned to 4, the pixels of a span that aren't completely inside fail its edge tests
+void math::occlusion_impl::raster_sse2(float *depth, int width, int height, Occluder const &occluder)
+{
+    Setup s;
+    if (!setup(occluder, width, height, s)) return;
+
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const lane_offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    __m128 ex[8], ox[8], pdx[3];
+    for (int i = 0; i < s.edge_count; ++i) {
+        ex[i] = _mm_set1_ps(s.ex[i]);
+        ox[i] = _mm_set1_ps(s.ox[i]);
+    }
+    for (int i = 0; i < s.plane_count; ++i)
+        pdx[i] = _mm_set1_ps(s.pdx[i]);
+
+    int const first = s.min_x & ~3;
+    for (int y = s.min_y; y <= s.max_y; ++y) {
+        float const py = static_cast<float>(y) + 0.5f;
+        // the parts of the edge functions and planes that only depend on the row
+        __m128 edge_rows[8], plane_rows[3];
+        for (int i = 0; i < s.edge_count; ++i)
+            edge_rows[i] = _mm_set1_ps(s.ey[i] * (py - s.oy[i]) - s.margin[i]);
+        for (int i = 0; i < s.plane_count; ++i)
+            plane_rows[i] = _mm_set1_ps(s.pz[i] + s.pdy[i] * py);
+
+        float *const row = depth + static_cast<std::ptrdiff_t>(y) * width;
+        for (int x = first; x <= s.max_x; x += 4) {
+            __m128 const px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_offsets);
+            __m128 outside = zero;
+            for (int i = 0; i < s.edge_count; ++i)
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(edge_rows[i], _mm_mul_ps(ex[i], _mm_sub_ps(px, ox[i]))), zero));
+            if (_mm_movemask_ps(outside) == 0xF) continue;
+
+            __m128 z = _mm_add_ps(plane_rows[0], _mm_mul_ps(pdx[0], px));
+            for (int i = 1; i < s.plane_count; ++i)
+                z = _mm_max_ps(z, _mm_add_ps(plane_rows[i], _mm_mul_ps(pdx[i], px)));
+            __m128 const old = _mm_loadu_ps(row + x);
+            __m128 const nearest = _mm_min_ps(old, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(outside, old), _mm_andnot_ps(outside, nearest)));
+        }
+    }
+}
+
+#pragma GCC pop_options
+
+#endif
\ No newline at end of file
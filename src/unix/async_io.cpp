@@ -0,0 +1,492 @@
+#include <engine/system/async_io.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <stdio.h> // fileno
+#include <sys/mman.h> // mmap, munmap
+#include <sys/syscall.h> // SYS_io_uring_*
+#include <sys/uio.h> // struct iovec
+#include <unistd.h> // syscall, close
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+    // big enough for an uncompressed chunk payload, bigger requests use a temporary buffer
+    constexpr std::size_t fixed_buffer_size = 64 * 1024;
+    // user_data of the request waking up the completion thread so it can exit
+    constexpr std::uint64_t wake_up_tag = 0;
+
+    int io_uring_setup(unsigned entries, ::io_uring_params *params) noexcept
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_setup, entries, params));
+    }
+
+    int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    int io_uring_register(int fd, unsigned opcode, void const *arg, unsigned nr_args) noexcept
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_register, fd, opcode, arg, nr_args));
+    }
+
+    struct Mapping {
+        void *address = MAP_FAILED;
+        std::size_t size = 0;
+
+        Mapping() noexcept = default;
+        Mapping(void *address, std::size_t size) noexcept
+            : address(address)
+            , size(size)
+        {
+        }
+        Mapping(Mapping &&other) noexcept
+            : address(std::exchange(other.address, MAP_FAILED))
+            , size(std::exchange(other.size, 0))
+        {
+        }
+        Mapping &operator=(Mapping &&other) noexcept
+        {
+            std::swap(address, other.address);
+            std::swap(size, other.size);
+            return *this;
+        }
+        ~Mapping()
+        {
+            if (address != MAP_FAILED) ::munmap(address, size);
+        }
+
+        [[nodiscard]]
+        std::byte *bytes() const noexcept
+        {
+            return static_cast<std::byte *>(address);
+        }
+    };
+
+    Mapping map_ring(int fd, std::size_t size, off_t offset)
+    {
+        void *const address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        if (address == MAP_FAILED) {
+            int const error = errno;
+            throw std::system_error(error, std::system_category(), "mmap() failed");
+        }
+        return Mapping(address, size);
+    }
+
+    template <typename T>
+    T load_acquire(T *p) noexcept
+    {
+        return std::atomic_ref(*p).load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    void store_release(T *p, T value) noexcept
+    {
+        std::atomic_ref(*p).store(value, std::memory_order_release);
+    }
+
+    class UringIO final : public engine::system::IAsyncIO {
+    public:
+        explicit UringIO(unsigned entries);
+        ~UringIO() override;
+
+        void queue_read(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::size_t size, ReadCallback callback) override
+        {
+            auto request = std::make_unique<Request>();
+            request->fd = file_descriptor(fp);
+            request->offset = offset;
+            request->size = size;
+            request->on_read = std::move(callback);
+
+            std::scoped_lock lock { m_mutex };
+            m_queued.push_back(std::move(request));
+        }
+
+        void queue_write(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::vector<std::byte> data, WriteCallback callback) override
+        {
+            auto request = std::make_unique<Request>();
+            request->is_write = true;
+            request->fd = file_descriptor(fp);
+            request->offset = offset;
+            request->size = data.size();
+            request->data = std::move(data);
+            request->on_write = std::move(callback);
+
+            std::scoped_lock lock { m_mutex };
+            m_queued.push_back(std::move(request));
+        }
+
+        void submit() override
+        {
+            std::scoped_lock lock { m_mutex };
+            m_in_flight += m_queued.size();
+            for (auto &request : m_queued)
+                m_backlog.push_back(std::move(request));
+            m_queued.clear();
+            pump();
+        }
+
+        void wait_idle() override
+        {
+            std::unique_lock lock { m_mutex };
+            m_idle.wait(lock, [this] { return m_in_flight == 0; });
+        }
+
+    private:
+        struct Request {
+            bool is_write = false;
+            int fd = -1;
+            std::uint64_t offset = 0;
+            std::size_t size = 0;
+            // bytes transferred so far, the kernel is allowed to do partial reads and writes
+            std::size_t done = 0;
+
+            // registered buffer, -1 if the request uses its own memory
+            int fixed_index = -1;
+            std::unique_ptr<std::byte[]> read_buffer;
+            std::vector<std::byte> data;
+            ::iovec iov {};
+
+            ReadCallback on_read;
+            WriteCallback on_write;
+        };
+
+        static int file_descriptor(std::FILE *fp)
+        {
+            int const fd = ::fileno(fp);
+            if (fd == -1) {
+                int const error = errno;
+                throw std::system_error(error, std::system_category(), "fileno() failed");
+            }
+            return fd;
+        }
+
+        std::byte *buffer_of(Request &request) noexcept
+        {
+            if (request.fixed_index != -1) return m_fixed_buffers.bytes() + request.fixed_index * fixed_buffer_size;
+            if (request.is_write) return request.data.data();
+            return request.read_buffer.get();
+        }
+
+        // picks the memory the kernel reads from or writes to, registered if possible
+        void prepare_buffer(Request &request)
+        {
+            if (request.fixed_index != -1 || request.read_buffer || (request.is_write && request.done != 0)) return;
+
+            if (request.size <= fixed_buffer_size && !m_free_buffers.empty()) {
+                request.fixed_index = m_free_buffers.back();
+                m_free_buffers.pop_back();
+                if (request.is_write) {
+                    std::ranges::copy(request.data, buffer_of(request));
+                    request.data = {};
+                }
+            } else if (!request.is_write) {
+                request.read_buffer = std::make_unique_for_overwrite<std::byte[]>(request.size);
+            }
+        }
+
+        // moves requests from the backlog to the submission queue and submits them, m_mutex must be held
+        void pump();
+        void complete(Request *, int result);
+        void finish(std::unique_ptr<Request>, std::error_code);
+        void completion_thread();
+
+        // the kernel only sees the entry once enter_submit() publishes the tail, after it was filled
+        ::io_uring_sqe &next_sqe() noexcept
+        {
+            auto const index = m_sq_local_tail++ & *m_sq_mask;
+            m_sq_array[index] = index;
+            auto &sqe = m_sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            return sqe;
+        }
+
+        [[nodiscard]]
+        unsigned sq_space() const noexcept
+        {
+            return m_sq_entries - (m_sq_local_tail - load_acquire(m_sq_head));
+        }
+
+        // publishes the entries filled since the last call and submits them
+        void enter_submit();
+
+        int m_fd = -1;
+        Mapping m_sq_ring;
+        Mapping m_cq_ring;
+        Mapping m_sqes_mapping;
+        Mapping m_fixed_buffers;
+
+        unsigned m_sq_entries = 0;
+        unsigned m_cq_entries = 0;
+        unsigned *m_sq_head = nullptr;
+        unsigned *m_sq_tail = nullptr;
+        unsigned *m_sq_mask = nullptr;
+        unsigned *m_sq_array = nullptr;
+        // tail of the entries filled so far, ahead of the shared one until they are submitted
+        unsigned m_sq_local_tail = 0;
+        ::io_uring_sqe *m_sqes = nullptr;
+        unsigned *m_cq_head = nullptr;
+        unsigned *m_cq_tail = nullptr;
+        unsigned *m_cq_mask = nullptr;
+        ::io_uring_cqe *m_cqes = nullptr;
+
+        std::mutex m_mutex;
+        std::condition_variable m_idle;
+        std::vector<std::unique_ptr<Request>> m_queued;
+        std::deque<std::unique_ptr<Request>> m_backlog;
+        std::vector<int> m_free_buffers;
+        // submitted but not yet completed, includes the backlog
+        std::size_t m_in_flight = 0;
+        // inside the ring, kept under the completion queue size so completions are never dropped
+        std::size_t m_in_ring = 0;
+        bool m_stopping = false;
+
+        std::thread m_thread;
+    };
+
+}
+
+UringIO::UringIO(unsigned entries)
+{
+    ::io_uring_params params {};
+    m_fd = io_uring_setup(entries, &params);
+    if (m_fd < 0) {
+        int const error = errno;
+        throw std::system_error(error, std::system_category(), "io_uring_setup() failed");
+    }
+
+    try {
+        std::size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        std::size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+            m_sq_ring = map_ring(m_fd, sq_size, IORING_OFF_SQ_RING);
+        } else {
+            m_sq_ring = map_ring(m_fd, sq_size, IORING_OFF_SQ_RING);
+            m_cq_ring = map_ring(m_fd, cq_size, IORING_OFF_CQ_RING);
+        }
+        auto *const sq = m_sq_ring.bytes();
+        auto *const cq = params.features & IORING_FEAT_SINGLE_MMAP ? m_sq_ring.bytes() : m_cq_ring.bytes();
+        m_sqes_mapping = map_ring(m_fd, params.sq_entries * sizeof(::io_uring_sqe), IORING_OFF_SQES);
+
+        m_sq_entries = params.sq_entries;
+        m_cq_entries = params.cq_entries;
+        m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        m_sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        m_sq_local_tail = *m_sq_tail;
+        m_sqes = reinterpret_cast<::io_uring_sqe *>(m_sqes_mapping.bytes());
+        m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        m_cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<::io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // one registered buffer per submission slot, saves pinning pages on every request
+        auto const buffers_size = std::size_t { m_sq_entries } * fixed_buffer_size;
+        void *const buffers = ::mmap(nullptr, buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffers != MAP_FAILED) {
+            m_fixed_buffers = Mapping(buffers, buffers_size);
+
+            std::vector<::iovec> iovecs(m_sq_entries);
+            for (unsigned i = 0; i < m_sq_entries; ++i)
+                iovecs[i] = ::iovec { m_fixed_buffers.bytes() + i * fixed_buffer_size, fixed_buffer_size };
+
+            if (io_uring_register(m_fd, IORING_REGISTER_BUFFERS, iovecs.data(), m_sq_entries) == 0) {
+                m_free_buffers.resize(m_sq_entries);
+                for (unsigned i = 0; i < m_sq_entries; ++i)
+                    m_free_buffers[i] = static_cast<int>(m_sq_entries - 1 - i);
+            } else {
+                // usually RLIMIT_MEMLOCK, still works without them
+                SPDLOG_WARN("failed to register io_uring buffers: {}", std::strerror(errno));
+                m_fixed_buffers = Mapping();
+            }
+        }
+
+        m_thread = std::thread(&UringIO::completion_thread, this);
+    } catch (...) {
+        ::close(m_fd);
+        throw;
+    }
+}
+
+UringIO::~UringIO()
+{
+    submit();
+    wait_idle();
+
+    {
+        std::scoped_lock lock { m_mutex };
+        m_stopping = true;
+        auto &sqe = next_sqe();
+        sqe.opcode = IORING_OP_NOP;
+        sqe.user_data = wake_up_tag;
+        enter_submit();
+    }
+    m_thread.join();
+
+    // the rings have to be unmapped before the descriptor is closed
+    m_fixed_buffers = Mapping();
+    m_sqes_mapping = Mapping();
+    m_cq_ring = Mapping();
+    m_sq_ring = Mapping();
+    ::close(m_fd);
+}
+
+void UringIO::enter_submit()
+{
+    store_release(m_sq_tail, m_sq_local_tail);
+    for (;;) {
+        auto const to_submit = m_sq_local_tail - load_acquire(m_sq_head);
+        if (to_submit == 0) return;
+        if (io_uring_enter(m_fd, to_submit, 0, 0) >= 0) return;
+
+        int const error = errno;
+        if (error == EINTR) continue;
+        // the requests stay in the ring and go out with the next submission
+        if (error == EAGAIN || error == EBUSY) return;
+        SPDLOG_ERROR("io_uring_enter() failed: {}", std::strerror(error));
+        return;
+    }
+}
+
+void UringIO::pump()
+{
+    // one slot is kept for the wake up request
+    while (!m_backlog.empty() && sq_space() > 1 && m_in_ring + 1 < m_cq_entries) {
+        auto request = std::move(m_backlog.front());
+        m_backlog.pop_front();
+
+        prepare_buffer(*request);
+        auto *const buffer = buffer_of(*request) + request->done;
+        auto const remaining = static_cast<unsigned>(request->size - request->done);
+
+        auto &sqe = next_sqe();
+        sqe.fd = request->fd;
+        sqe.off = request->offset + request->done;
+        if (request->fixed_index != -1) {
+            sqe.opcode = request->is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(buffer);
+            sqe.len = remaining;
+            sqe.buf_index = static_cast<std::uint16_t>(request->fixed_index);
+        } else {
+            request->iov = ::iovec { buffer, remaining };
+            sqe.opcode = request->is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(&request->iov);
+            sqe.len = 1;
+        }
+        sqe.user_data = reinterpret_cast<std::uintptr_t>(request.release());
+        ++m_in_ring;
+    }
+    enter_submit();
+}
+
+void UringIO::complete(Request *raw_request, int result)
+{
+    std::unique_ptr<Request> request(raw_request);
+
+    if (result < 0) {
+        if (-result == EAGAIN || -result == EINTR) {
+            std::scoped_lock lock { m_mutex };
+            m_backlog.push_front(std::move(request));
+            return;
+        }
+        return finish(std::move(request), std::error_code(-result, std::system_category()));
+    }
+
+    request->done += static_cast<std::size_t>(result);
+    bool const end_of_file = result == 0 && !request->is_write;
+    if (request->done < request->size && !end_of_file) {
+        if (result == 0) return finish(std::move(request), std::make_error_code(std::errc::io_error));
+        std::scoped_lock lock { m_mutex };
+        m_backlog.push_front(std::move(request));
+        return;
+    }
+
+    finish(std::move(request), {});
+}
+
+void UringIO::finish(std::unique_ptr<Request> request, std::error_code error)
+{
+    try {
+        if (request->is_write) {
+            if (request->on_write) request->on_write(error);
+        } else if (request->on_read) {
+            auto const bytes = error ? std::span<std::byte const>() : std::span<std::byte const>(buffer_of(*request), request->done);
+            request->on_read(error, bytes);
+        }
+    } catch (std::exception const &e) {
+        SPDLOG_ERROR("asynchronous I/O callback failed: {}", e.what());
+    }
+
+    {
+        std::scoped_lock lock { m_mutex };
+        if (request->fixed_index != -1)
+            m_free_buffers.push_back(request->fixed_index);
+        --m_in_flight;
+    }
+    m_idle.notify_all();
+}
+
+void UringIO::completion_thread()
+{
+    std::vector<std::pair<std::uint64_t, int>> completions;
+    for (;;) {
+        if (io_uring_enter(m_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            SPDLOG_ERROR("io_uring_enter() failed: {}", std::strerror(errno));
+        }
+
+        completions.clear();
+        auto head = *m_cq_head;
+        auto const tail = load_acquire(m_cq_tail);
+        for (; head != tail; ++head) {
+            auto const &cqe = m_cqes[head & *m_cq_mask];
+            completions.emplace_back(cqe.user_data, cqe.res);
+        }
+        store_release(m_cq_head, head);
+
+        bool woken_up = false;
+        {
+            std::scoped_lock lock { m_mutex };
+            for (auto const &[user_data, result] : completions)
+                if (user_data != wake_up_tag) --m_in_ring;
+        }
+        for (auto const &[user_data, result] : completions) {
+            if (user_data == wake_up_tag)
+                woken_up = true;
+            else
+                complete(reinterpret_cast<Request *>(user_data), result);
+        }
+
+        std::scoped_lock lock { m_mutex };
+        pump();
+        if (woken_up && m_stopping) return;
+    }
+}
+
+#endif
+
+std::unique_ptr<engine::system::IAsyncIO> engine::system::make_async_io(std::size_t queue_depth)
+{
+#ifdef __linux__
+    try {
+        return std::make_unique<UringIO>(static_cast<unsigned>(queue_depth));
+    } catch (std::system_error const &e) {
+        SPDLOG_WARN("io_uring is not available ({}), using a thread pool", e.what());
+    }
+#endif
+    return engine::system::make_thread_pool_io(std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u));
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include <engine/system/positioned_io.hpp>
+
+#include <stdio.h> // fileno
+#include <unistd.h> // pread, pwrite, fsync, fdatasync
+
+#include <cerrno>
+#include <system_error>
+
+static int file_descriptor(std::FILE *fp)
+{
+    int const fd = ::fileno(fp);
+    if (fd == -1) {
+        int const error = errno;
+        throw std::system_error(error, std::system_category(), "fileno() failed");
+    }
+    return fd;
+}
+
+std::size_t engine::system::read_at(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::span<std::byte> data)
+{
+    int const fd = file_descriptor(fp);
+
+    std::size_t total = 0;
+    while (total < data.size()) {
+        ::ssize_t const n = ::pread(fd, data.data() + total, data.size() - total, static_cast<::off_t>(offset + total));
+        if (n == -1) {
+            int const error = errno;
+            if (error == EINTR) continue;
+            throw std::system_error(error, std::system_category(), "pread() failed");
+        }
+        if (n == 0) break; // end of file
+        total += static_cast<std::size_t>(n);
+    }
+    return total;
+}
+
+void engine::system::write_at(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::span<std::byte const> data)
+{
+    int const fd = file_descriptor(fp);
+
+    std::size_t total = 0;
+    while (total < data.size()) {
+        ::ssize_t const n = ::pwrite(fd, data.data() + total, data.size() - total, static_cast<::off_t>(offset + total));
+        if (n == -1) {
+            int const error = errno;
+            if (error == EINTR) continue;
+            throw std::system_error(error, std::system_category(), "pwrite() failed");
+        }
+        total += static_cast<std::size_t>(n);
+    }
+}
+
+void engine::system::sync(engine::nonnull<std::FILE> fp)
+{
+    if (std::fflush(fp) != 0) {
+        int const error = errno;
+        throw std::system_error(error, std::system_category(), "fflush() failed");
+    }
+
+    int const fd = file_descriptor(fp);
+#ifdef __linux__
+    if (::fdatasync(fd) == -1) {
+#else
+    if (::fsync(fd) == -1) {
+#endif
+        int const error = errno;
+        throw std::system_error(error, std::system_category(), "fsync() failed");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include <engine/system/async_io.hpp>
+
+#include <algorithm>
+#include <thread>
+
+std::unique_ptr<engine::system::IAsyncIO> engine::system::make_async_io(std::size_t)
+{
+    return engine::system::make_thread_pool_io(std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u));
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include <engine/system/positioned_io.hpp>
+
+#define WIN32_LEAN_AND_MEAN
+#include <io.h> // _get_osfhandle
+#include <stdio.h> // _fileno
+#include <windows.h>
+
+#include <algorithm>
+#include <system_error>
+
+static HANDLE file_handle(std::FILE *fp)
+{
+    int const fd = ::_fileno(fp);
+    if (fd == -1 || fd == -2) throw std::system_error(errno, std::generic_category(), "_fileno() failed");
+    intptr_t const handle = ::_get_osfhandle(fd);
+    if (handle == -1 || handle == -2) throw std::system_error(errno, std::generic_category(), "_get_osfhandle() failed");
+    return reinterpret_cast<HANDLE>(handle);
+}
+
+static OVERLAPPED overlapped_at(std::uint64_t offset) noexcept
+{
+    OVERLAPPED overlapped {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    return overlapped;
+}
+
+std::size_t engine::system::read_at(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::span<std::byte> data)
+{
+    HANDLE const handle = file_handle(fp);
+
+    std::size_t total = 0;
+    while (total < data.size()) {
+        auto overlapped = overlapped_at(offset + total);
+        auto const to_read = static_cast<DWORD>(std::min<std::size_t>(data.size() - total, MAXDWORD));
+        DWORD n = 0;
+        if (!::ReadFile(handle, data.data() + total, to_read, &n, &overlapped)) {
+            DWORD const error = ::GetLastError();
+            if (error == ERROR_HANDLE_EOF) break;
+            throw std::system_error(static_cast<int>(error), std::system_category(), "ReadFile() failed");
+        }
+        if (n == 0) break;
+        total += n;
+    }
+    return total;
+}
+
+void engine::system::write_at(engine::nonnull<std::FILE> fp, std::uint64_t offset, std::span<std::byte const> data)
+{
+    HANDLE const handle = file_handle(fp);
+
+    std::size_t total = 0;
+    while (total < data.size()) {
+        auto overlapped = overlapped_at(offset + total);
+        auto const to_write = static_cast<DWORD>(std::min<std::size_t>(data.size() - total, MAXDWORD));
+        DWORD n = 0;
+        if (!::WriteFile(handle, data.data() + total, to_write, &n, &overlapped))
+            throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "WriteFile() failed");
+        total += n;
+    }
+}
+
+void engine::system::sync(engine::nonnull<std::FILE> fp)
+{
+    if (std::fflush(fp) != 0)
+        throw std::system_error(errno, std::generic_category(), "fflush() failed");
+    if (!::FlushFileBuffers(file_handle(fp)))
+        throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "FlushFileBuffers() failed");
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include <math/noise.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// the kernels only differ from the scalar one in rounding
+namespace {
+    constexpr float tolerance = 1e-4f;
+
+    constexpr math::noise::Type types[] = { math::noise::Type::value, math::noise::Type::perlin, math::noise::Type::simplex, math::noise::Type::cellular };
+    constexpr char const *type_names[] = { "value", "perlin", "simplex", "cellular" };
+    constexpr char const *kernel_names[] = { "scalar", "sse2", "avx2" };
+
+    // around the origin, far from it and across cell boundaries at several frequencies
+    constexpr glm::ivec3 origins[] = { { 0, 0, 0 }, { -24, -40, 40 }, { 8, -3, -8 }, { 1 << 20, 77, -(1 << 20) } };
+
+    std::array<float, math::noise::grid_size * math::noise::grid_size * math::noise::grid_size> expected, actual;
+    int failures = 0;
+}
+
+// the first count samples of the grids
+static void compare(std::size_t count, math::noise::Kernel kernel, math::noise::Settings const &settings, glm::ivec3 origin, char const *dimensions)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        if (std::abs(expected[i] - actual[i]) <= tolerance) continue;
+        std::fprintf(stderr, "%s %s noise of kernel %s at (%d, %d, %d) octaves %u: sample %zu is %f, expected %f\n",
+            dimensions, type_names[static_cast<std::size_t>(settings.type)], kernel_names[static_cast<std::size_t>(kernel)],
+            origin.x, origin.y, origin.z, settings.octaves, i, actual[i], expected[i]);
+        ++failures;
+        return;
+    }
+}
+
+int main()
+{
+    using namespace math::noise;
+    constexpr std::size_t size_2d = grid_size * grid_size;
+
+    for (auto const kernel : { Kernel::sse2, Kernel::avx2 }) {
+        if (!is_supported(kernel)) {
+            std::printf("kernel %s isn't supported, skipped\n", kernel_names[static_cast<std::size_t>(kernel)]);
+            continue;
+        }
+
+        for (auto const type : types) {
+            for (std::uint32_t octaves = 1; octaves <= 4; octaves += 3) {
+                Settings const settings {
+                    .type = type,
+                    .seed = 1337,
+                    .frequency = 1.0f / 7.0f,
+                    .octaves = octaves,
+                };
+
+                for (auto const origin : origins) {
+                    fill_2d(Kernel::scalar, settings, { origin.x, origin.z }, Grid2D(expected.data(), size_2d));
+                    fill_2d(kernel, settings, { origin.x, origin.z }, Grid2D(actual.data(), size_2d));
+                    compare(size_2d, kernel, settings, origin, "2d");
+
+                    fill_3d(Kernel::scalar, settings, origin, expected);
+                    fill_3d(kernel, settings, origin, actual);
+                    compare(expected.size(), kernel, settings, origin, "3d");
+                }
+            }
+        }
+    }
+
+    if (failures) return EXIT_FAILURE;
+    std::puts("noise ok");
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <math/occlusion.hpp>
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+// the camera is at the origin looking down -z with a 90 degree vertical fov, so a point is
+// (x / -z / aspect + 1) / 2 * width pixels from the left
+namespace {
+    constexpr float aspect = static_cast<float>(math::OcclusionBuffer::width) / math::OcclusionBuffer::height;
+    constexpr float occluder_near = 5.0f, occluder_far = 6.0f;
+    constexpr float box_near = 20.0f, box_far = 20.05f;
+
+    int failures = 0;
+}
+
+// x / -z of the point drawn at pixel column x
+static float slope(float x)
+{
+    return (x / math::OcclusionBuffer::width * 2.0f - 1.0f) * aspect;
+}
+
+static void check(bool condition, char const *what, float edge)
+{
+    if (condition) return;
+    std::fprintf(stderr, "%s, occluder edge at pixel %.2f\n", what, edge);
+    ++failures;
+}
+
+int main()
+{
+    math::OcclusionBuffer buffer;
+    glm::mat4 const projection = glm::perspective(glm::radians(90.0f), aspect, 0.1f, 100.0f);
+
+    // the right edge of the occluder at every quarter of a pixel, its near face is the widest it gets on screen
+    for (float edge = 160.0f; edge < 161.0f; edge += 0.25f) {
+        float const half_width = slope(edge) * occluder_near;
+        buffer.clear(projection);
+        buffer.add_occluder({ -half_width, -half_width, -occluder_far }, { half_width, half_width, -occluder_near });
+        buffer.build_hierarchy();
+
+        // well behind the occluder and inside it on screen
+        float const inside = slope(edge - 8.0f) * box_near;
+        check(buffer.is_occluded({ -inside, -inside, -box_far }, { inside, inside, -box_near }), "box behind the occluder isn't occluded", edge);
+
+        // right of the edge in the texel the edge goes through and only two texels high, so it is tested against the depth buffer itself
+        // its far face is the leftmost it gets on screen and its near one the rightmost
+        float const right = slope(160.99f) * box_near;
+        check(!buffer.is_occluded({ slope(edge + 0.01f) * box_far, -0.02f, -box_far }, { right, 0.02f, -box_near }), "box beside the occluder edge is occluded", edge);
+    }
+
+    if (failures) return EXIT_FAILURE;
+    std::puts("occlusion ok");
+    return EXIT_SUCCESS;
+}
\ No newline at end of file